@@ -0,0 +1,204 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include "dynamic_circular_buffer.h"
+
+// Runs posted coroutines one after another on the calling thread.
+class single_thread_executor {
+public:
+    void post(std::coroutine_handle<> handle) {
+        m_ready.push_back(handle);
+    }
+    // resumes coroutines until none is ready, returns how many were resumed
+    size_t run() {
+        size_t count = 0;
+        while (!m_ready.empty()) {
+            std::coroutine_handle<> handle = m_ready.front();
+            m_ready.pop_front();
+            handle.resume();
+            ++count;
+        }
+        return count;
+    }
+    bool empty() const noexcept {
+        return m_ready.empty();
+    }
+
+private:
+    dynamic_circular_buffer<std::coroutine_handle<>> m_ready;
+};
+
+// Coroutine that starts right away and frees itself when it finishes.
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+// Bounded channel between coroutines on one executor. co_await push(x) suspends only when the
+// channel is full and co_await pop() only when it is empty. Suspended coroutines are kept in
+// intrusive FIFO lists threaded through their awaiters, which live in the coroutine frames,
+// so no operation allocates. Not thread safe: every coroutine has to run on the executor.
+template <class T, class Executor = single_thread_executor, class Alloc = std::allocator<T>>
+class async_channel {
+    template <class Waiter>
+    class waiter_list {
+    public:
+        void push(Waiter* waiter) noexcept {
+            waiter->m_next = nullptr;
+            if (m_tail == nullptr)
+                m_head = waiter;
+            else
+                m_tail->m_next = waiter;
+            m_tail = waiter;
+        }
+        Waiter* pop() noexcept {
+            Waiter* waiter = m_head;
+            m_head = waiter->m_next;
+            if (m_head == nullptr)
+                m_tail = nullptr;
+            return waiter;
+        }
+        bool empty() const noexcept {
+            return m_head == nullptr;
+        }
+
+    private:
+        Waiter* m_head = nullptr;
+        Waiter* m_tail = nullptr;
+    };
+
+public:
+    using value_type = T;
+
+    class push_awaiter {
+    public:
+        push_awaiter(async_channel& channel, T&& val)
+            : m_channel(channel), m_value(std::move(val)) {}
+
+        bool await_ready() {
+            return m_channel.try_push(m_value);
+        }
+        void await_suspend(std::coroutine_handle<> handle) noexcept {
+            m_handle = handle;
+            m_channel.m_pushers.push(this);
+        }
+        void await_resume() const noexcept {}
+
+    private:
+        friend class async_channel;
+        friend class waiter_list<push_awaiter>;
+
+        async_channel& m_channel;
+        T m_value;
+        std::coroutine_handle<> m_handle;
+        push_awaiter* m_next = nullptr;
+    };
+
+    class pop_awaiter {
+    public:
+        explicit pop_awaiter(async_channel& channel)
+            : m_channel(channel) {}
+
+        bool await_ready() {
+            return m_channel.try_pop(m_value);
+        }
+        void await_suspend(std::coroutine_handle<> handle) noexcept {
+            m_handle = handle;
+            m_channel.m_poppers.push(this);
+        }
+        T await_resume() {
+            return std::move(*m_value);
+        }
+
+    private:
+        friend class async_channel;
+        friend class waiter_list<pop_awaiter>;
+
+        async_channel& m_channel;
+        std::optional<T> m_value;
+        std::coroutine_handle<> m_handle;
+        pop_awaiter* m_next = nullptr;
+    };
+
+    // capacity 0 makes every push wait for a matching pop
+    async_channel(Executor& executor, size_t capacity, const Alloc& alloc = Alloc())
+        : m_executor(executor), m_buffer(alloc), m_capacity(capacity) {
+        m_buffer.reserve(capacity);
+    }
+    async_channel(const async_channel&) = delete;
+    async_channel& operator =(const async_channel&) = delete;
+
+    [[nodiscard]] push_awaiter push(T val) {
+        return push_awaiter(*this, std::move(val));
+    }
+    [[nodiscard]] pop_awaiter pop() {
+        return pop_awaiter(*this);
+    }
+
+    size_t size() const noexcept {
+        return m_buffer.size();
+    }
+    size_t capacity() const noexcept {
+        return m_capacity;
+    }
+    bool empty() const noexcept {
+        return m_buffer.empty();
+    }
+
+private:
+    // hands the value to the oldest waiting pop, or stores it if there is room
+    bool try_push(T& val) {
+        if (!m_poppers.empty()) {
+            pop_awaiter* popper = m_poppers.pop();
+            popper->m_value.emplace(std::move(val));
+            m_executor.post(popper->m_handle);
+            return true;
+        }
+        if (m_buffer.size() == m_capacity)
+            return false;
+        m_buffer.push_back(std::move(val));
+        return true;
+    }
+    // takes the oldest value and lets the oldest waiting push move into the freed slot
+    bool try_pop(std::optional<T>& val) {
+        if (m_buffer.empty()) {
+            if (m_pushers.empty())
+                return false;
+            push_awaiter* pusher = m_pushers.pop();
+            val.emplace(std::move(pusher->m_value));
+            m_executor.post(pusher->m_handle);
+            return true;
+        }
+        val.emplace(std::move(m_buffer.front()));
+        m_buffer.pop_front();
+        if (!m_pushers.empty()) {
+            push_awaiter* pusher = m_pushers.pop();
+            m_buffer.push_back(std::move(pusher->m_value));
+            m_executor.post(pusher->m_handle);
+        }
+        return true;
+    }
+
+    Executor& m_executor;
+    dynamic_circular_buffer<T, Alloc> m_buffer;
+    size_t m_capacity;
+    waiter_list<push_awaiter> m_pushers;
+    waiter_list<pop_awaiter> m_poppers;
+};
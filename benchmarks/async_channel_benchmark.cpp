@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include <future>
+#include "../async_channel.h"
+
+constexpr int64_t message_count = 1 << 16;
+
+detached_task produce(async_channel<int64_t>& channel, int64_t count) {
+    for (int64_t i = 0; i < count; ++i)
+        co_await channel.push(i);
+}
+
+detached_task consume(async_channel<int64_t>& channel, int64_t count, int64_t& sum) {
+    for (int64_t i = 0; i < count; ++i)
+        sum += co_await channel.pop();
+}
+
+void bm_channel(benchmark::State& state) {
+    for (auto _ : state) {
+        single_thread_executor executor;
+        async_channel<int64_t> channel(executor, state.range(0));
+        int64_t sum = 0;
+        produce(channel, message_count);
+        consume(channel, message_count, sum);
+        executor.run();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * message_count);
+}
+
+// every message gets its own promise and shared state
+void bm_future(benchmark::State& state) {
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < message_count; ++i) {
+            std::promise<int64_t> promise;
+            std::future<int64_t> future = promise.get_future();
+            promise.set_value(i);
+            sum += future.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * message_count);
+}
+
+BENCHMARK(bm_channel)->Arg(0)->Arg(16)->Arg(1024)->Unit(benchmark::kMicrosecond);
+BENCHMARK(bm_future)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../blocking_circular_queue.h"
+
+constexpr size_t queue_size = 1024;
+
+// the usual condition variable queue, notifying on every push and pop
+class cv_queue {
+public:
+    explicit cv_queue(size_t) {}
+
+    void push(int64_t val) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this] { return !m_buffer.full(); });
+        m_buffer.push_back(val);
+        lock.unlock();
+        m_not_empty.notify_one();
+    }
+    template <class OutputIt>
+    size_t pop_batch(OutputIt out, size_t max) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this] { return !m_buffer.empty(); });
+        size_t n = 0;
+        for (; n != max && !m_buffer.empty(); ++n, ++out) {
+            *out = m_buffer.front();
+            m_buffer.pop_front();
+        }
+        lock.unlock();
+        m_not_full.notify_one();
+        return n;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    circular_buffer<int64_t, queue_size> m_buffer;
+};
+
+template <class Queue>
+void bm_producer_consumer(benchmark::State& state) {
+    const int64_t count = 1 << 18;
+    const size_t threshold = state.range(0);
+    size_t wakeups = 0;
+    for (auto _ : state) {
+        Queue queue(threshold);
+        std::thread consumer([&queue, count]() {
+            std::vector<int64_t> batch(64);
+            for (int64_t taken = 0; taken < count; )
+                taken += queue.pop_batch(batch.begin(), batch.size());
+            benchmark::DoNotOptimize(batch.data());
+        });
+        for (int64_t i = 0; i < count; ++i)
+            queue.push(i);
+        consumer.join();
+        if constexpr (requires { queue.consumer_wakeups(); })
+            wakeups += queue.consumer_wakeups();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    if constexpr (requires(Queue& queue) { queue.consumer_wakeups(); })
+        state.counters["wakeups_per_item"] = static_cast<double>(wakeups) / (state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(bm_producer_consumer, blocking_circular_queue<int64_t, queue_size>)
+    ->Arg(1)->Arg(16)->Arg(256)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_producer_consumer, cv_queue)
+    ->Arg(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../broadcast_circular_buffer.h"
+#include "../spsc_circular_buffer.h"
+
+constexpr size_t queue_size = 1024;
+constexpr size_t consumer_count = 4;
+
+struct message {
+    int64_t sequence;
+    std::array<double, 7> payload;
+};
+
+// one feed to four consumers through a single broadcast ring
+template <class FullPolicy>
+void bm_broadcast(benchmark::State& state) {
+    const int64_t count = state.range(0);
+    for (auto _ : state) {
+        broadcast_circular_buffer<message, queue_size, FullPolicy> ring(consumer_count);
+        std::vector<std::thread> consumers;
+        for (size_t c = 0; c != consumer_count; ++c) {
+            consumers.emplace_back([&ring, c, count]() {
+                message batch[64];
+                int64_t last = -1;
+                while (last != count - 1) {
+                    const size_t n = ring.read_batch(c, batch, 64);
+                    if (n == 0)
+                        std::this_thread::yield();
+                    else
+                        last = batch[n - 1].sequence;
+                    benchmark::DoNotOptimize(batch);
+                }
+            });
+        }
+        for (int64_t i = 0; i < count; ++i)
+            ring.publish(message{ i, {} });
+        for (std::thread& consumer : consumers)
+            consumer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// the same feed copied into one spsc queue per consumer
+void bm_queue_per_consumer(benchmark::State& state) {
+    const int64_t count = state.range(0);
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<spsc_circular_buffer<message, queue_size>>> queues;
+        for (size_t c = 0; c != consumer_count; ++c)
+            queues.push_back(std::make_unique<spsc_circular_buffer<message, queue_size>>());
+        std::vector<std::thread> consumers;
+        for (size_t c = 0; c != consumer_count; ++c) {
+            consumers.emplace_back([&queue = *queues[c], count]() {
+                message val;
+                for (int64_t i = 0; i < count; ++i) {
+                    while (!queue.try_pop(val))
+                        std::this_thread::yield();
+                    benchmark::DoNotOptimize(val);
+                }
+            });
+        }
+        for (int64_t i = 0; i < count; ++i) {
+            const message val{ i, {} };
+            for (auto& queue : queues)
+                while (!queue->try_push(val))
+                    std::this_thread::yield();
+        }
+        for (std::thread& consumer : consumers)
+            consumer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(bm_broadcast, block_when_full)->Arg(1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_broadcast, overwrite_oldest)->Arg(1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(bm_queue_per_consumer)->Arg(1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "../circular_buffer.h"
+
+constexpr size_t ingest_size = 1 << 20;
+constexpr size_t string_count = 1 << 12;
+
+template <size_t N>
+void bm_push_back_each(benchmark::State& state) {
+    std::vector<double> samples(ingest_size, 1.0);
+    circular_buffer<double, N> buffer;
+    for (auto _ : state) {
+        for (double sample : samples)
+            buffer.push_back(sample);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * ingest_size);
+}
+
+template <size_t N>
+void bm_write(benchmark::State& state) {
+    std::vector<double> samples(ingest_size, 1.0);
+    circular_buffer<double, N> buffer;
+    for (auto _ : state) {
+        buffer.write(samples.data(), samples.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * ingest_size);
+}
+
+void bm_push_back_each_strings(benchmark::State& state) {
+    std::vector<std::string> samples(string_count, std::string(32, 'x'));
+    circular_buffer<std::string, string_count + 1> buffer;
+    for (auto _ : state) {
+        for (const std::string& sample : samples)
+            buffer.push_back(sample);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * string_count);
+}
+
+void bm_push_back_range_strings(benchmark::State& state) {
+    std::vector<std::string> samples(string_count, std::string(32, 'x'));
+    circular_buffer<std::string, string_count + 1> buffer;
+    for (auto _ : state) {
+        buffer.push_back(samples.begin(), samples.end());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * string_count);
+}
+
+BENCHMARK_TEMPLATE(bm_push_back_each, ingest_size);
+BENCHMARK_TEMPLATE(bm_push_back_each, ingest_size / 3);
+BENCHMARK_TEMPLATE(bm_write, ingest_size);
+BENCHMARK_TEMPLATE(bm_write, ingest_size / 3);
+BENCHMARK(bm_push_back_each_strings);
+BENCHMARK(bm_push_back_range_strings);
@@ -0,0 +1,314 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include "../circular_buffer.h"
+#include "../dynamic_circular_buffer.h"
+
+struct pod64 {
+    std::int64_t words[8];
+};
+
+// fixed capacity ring over a plain array, the lower bound the buffers are measured against
+template <class T>
+class array_ring {
+public:
+    using value_type = T;
+
+    explicit array_ring(size_t capacity)
+        : m_data(new T[capacity]), m_capacity(capacity) {}
+    array_ring(const array_ring& other)
+        : m_data(new T[other.m_capacity]), m_capacity(other.m_capacity), m_head(other.m_head), m_size(other.m_size) {
+        std::copy(other.m_data.get(), other.m_data.get() + m_capacity, m_data.get());
+    }
+
+    void push_back(const T& val) {
+        m_data[(m_head + m_size) % m_capacity] = val;
+        if (m_size == m_capacity)
+            m_head = (m_head + 1) % m_capacity;
+        else
+            ++m_size;
+    }
+    void pop_front() {
+        m_head = (m_head + 1) % m_capacity;
+        --m_size;
+    }
+    T& operator [](size_t offset) {
+        return m_data[(m_head + offset) % m_capacity];
+    }
+    // the position keeps the ring full, so the oldest element is dropped
+    void insert(size_t offset, const T& val) {
+        for (size_t i = 0; i + 1 < offset; ++i)
+            (*this)[i] = std::move((*this)[i + 1]);
+        (*this)[offset - 1] = val;
+    }
+    template <class F>
+    void for_each(F f) {
+        const size_t first = std::min(m_size, m_capacity - m_head);
+        for (size_t i = m_head; i != m_head + first; ++i)
+            f(m_data[i]);
+        for (size_t i = 0; i != m_size - first; ++i)
+            f(m_data[i]);
+    }
+    void clear() noexcept {
+        m_head = m_size = 0;
+    }
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+private:
+    std::unique_ptr<T[]> m_data;
+    size_t m_capacity;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
+
+template <class T>
+T make_value(size_t i) {
+    if constexpr (std::is_same_v<T, std::string>)
+        return std::string(32, char('a' + i % 26));
+    else if constexpr (std::is_same_v<T, pod64>)
+        return pod64{ { std::int64_t(i) } };
+    else
+        return T(i);
+}
+
+template <class T>
+double key(const T& val) {
+    if constexpr (std::is_same_v<T, std::string>)
+        return double(val.size());
+    else if constexpr (std::is_same_v<T, pod64>)
+        return double(val.words[0]);
+    else
+        return double(val);
+}
+
+template <class Buffer>
+Buffer make_buffer(size_t n) {
+    if constexpr (std::is_same_v<Buffer, array_ring<typename Buffer::value_type>>) {
+        return Buffer(n);
+    }
+    else {
+        Buffer buffer;
+        if constexpr (requires { buffer.reserve(n); })
+            buffer.reserve(n);
+        return buffer;
+    }
+}
+
+// leaves n elements that wrap around the end of the storage
+template <class Buffer, class T>
+void fill(Buffer& buffer, size_t n, const T& val) {
+    for (size_t i = 0; i != n; ++i)
+        buffer.push_back(val);
+    for (size_t i = 0; i != n / 2; ++i)
+        buffer.pop_front();
+    for (size_t i = 0; i != n / 2; ++i)
+        buffer.push_back(val);
+}
+
+template <class F>
+double seconds(F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(benchmark::State& state, size_t ops_per_iteration, double total_seconds) {
+    const double ops = double(state.iterations()) * ops_per_iteration;
+    state.SetItemsProcessed(int64_t(ops));
+    state.counters["ns/op"] = ops == 0 ? 0 : total_seconds * 1e9 / ops;
+}
+
+template <class Buffer>
+void bm_push(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    const T val = make_value<T>(1);
+    Buffer buffer = make_buffer<Buffer>(n);
+    double total = 0;
+    for (auto _ : state) {
+        const double elapsed = seconds([&] {
+            for (size_t i = 0; i != n; ++i)
+                buffer.push_back(val);
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+        buffer.clear();
+    }
+    report(state, n, total);
+}
+
+template <class Buffer>
+void bm_pop(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    const T val = make_value<T>(1);
+    Buffer buffer = make_buffer<Buffer>(n);
+    double total = 0;
+    for (auto _ : state) {
+        fill(buffer, n, val);
+        const double elapsed = seconds([&] {
+            for (size_t i = 0; i != n; ++i)
+                buffer.pop_front();
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, n, total);
+}
+
+template <class Buffer>
+void bm_iterate(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    Buffer buffer = make_buffer<Buffer>(n);
+    fill(buffer, n, make_value<T>(1));
+    double total = 0;
+    for (auto _ : state) {
+        const double elapsed = seconds([&] {
+            double sum = 0;
+            if constexpr (std::is_same_v<Buffer, array_ring<T>>) {
+                buffer.for_each([&](const T& val) { sum += key(val); });
+            }
+            else {
+                for (const T& val : buffer)
+                    sum += key(val);
+            }
+            benchmark::DoNotOptimize(sum);
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, n, total);
+}
+
+template <class Buffer>
+void bm_random_access(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    Buffer buffer = make_buffer<Buffer>(n);
+    fill(buffer, n, make_value<T>(1));
+    double total = 0;
+    for (auto _ : state) {
+        const double elapsed = seconds([&] {
+            double sum = 0;
+            // full period walk over the power of two sizes
+            size_t index = 0;
+            for (size_t i = 0; i != n; ++i) {
+                index = (index * 5 + 1) & (n - 1);
+                sum += key(buffer[index]);
+            }
+            benchmark::DoNotOptimize(sum);
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, n, total);
+}
+
+// circular_buffer::insert replaces the element at the position, std::deque shifts and is trimmed back to n
+template <class Buffer>
+void bm_insert(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    const T val = make_value<T>(2);
+    Buffer buffer = make_buffer<Buffer>(n);
+    fill(buffer, n, make_value<T>(1));
+    double total = 0;
+    for (auto _ : state) {
+        const double elapsed = seconds([&] {
+            if constexpr (std::is_same_v<Buffer, array_ring<T>>) {
+                buffer.insert(n / 2, val);
+            }
+            else if constexpr (std::is_same_v<Buffer, std::deque<T>>) {
+                buffer.insert(buffer.begin() + n / 2, val);
+                buffer.pop_front();
+            }
+            else {
+                auto it = buffer.begin();
+                it += n / 2;
+                buffer.insert(it, T(val));
+            }
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, 1, total);
+}
+
+template <class Buffer>
+void bm_resize(benchmark::State& state) {
+    const size_t n = state.range(0);
+    double total = 0;
+    for (auto _ : state) {
+        Buffer buffer;
+        const double elapsed = seconds([&] {
+            buffer.resize(n);
+        });
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, n, total);
+}
+
+template <class Buffer>
+void bm_copy(benchmark::State& state) {
+    using T = typename Buffer::value_type;
+    const size_t n = state.range(0);
+    Buffer buffer = make_buffer<Buffer>(n);
+    fill(buffer, n, make_value<T>(1));
+    double total = 0;
+    for (auto _ : state) {
+        std::unique_ptr<Buffer> copy;
+        const double elapsed = seconds([&] {
+            copy = std::make_unique<Buffer>(buffer);
+        });
+        benchmark::DoNotOptimize(copy.get());
+        state.SetIterationTime(elapsed);
+        total += elapsed;
+    }
+    report(state, n, total);
+}
+
+template <class Buffer>
+void register_buffer(const std::string& name, size_t n) {
+    const auto add = [&](const std::string& op, void (*fn)(benchmark::State&)) {
+        benchmark::RegisterBenchmark((op + "/" + name).c_str(), fn)->Arg(n)->UseManualTime();
+    };
+    add("push", bm_push<Buffer>);
+    add("pop", bm_pop<Buffer>);
+    add("iterate", bm_iterate<Buffer>);
+    add("random_access", bm_random_access<Buffer>);
+    add("insert", bm_insert<Buffer>);
+    if constexpr (requires(Buffer buffer) { buffer.resize(n); })
+        add("resize", bm_resize<Buffer>);
+    add("copy", bm_copy<Buffer>);
+}
+
+template <class T, size_t... Sizes>
+void register_type(const std::string& type) {
+    (register_buffer<circular_buffer<T, Sizes>>("circular_buffer<" + type + ">", Sizes), ...);
+    for (size_t n : { Sizes... }) {
+        register_buffer<dynamic_circular_buffer<T>>("dynamic_circular_buffer<" + type + ">", n);
+        register_buffer<std::deque<T>>("deque<" + type + ">", n);
+        register_buffer<array_ring<T>>("array_ring<" + type + ">", n);
+    }
+}
+
+template <class T>
+void register_sizes(const std::string& type) {
+    register_type<T, 16, 256, 4096, 65536, size_t(1) << 20, size_t(1) << 24>(type);
+}
+
+const bool registered = [] {
+    register_sizes<int>("int");
+    register_sizes<double>("double");
+    register_sizes<std::string>("string");
+    register_sizes<pod64>("pod64");
+    return true;
+}();
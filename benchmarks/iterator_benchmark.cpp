@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <numeric>
+#include "../circular_buffer.h"
+#include "../dynamic_circular_buffer.h"
+
+template <size_t N>
+void bm_accumulate_static(benchmark::State& state) {
+    circular_buffer<int64_t, N> buffer(1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(buffer.begin(), buffer.end(), int64_t(0)));
+    state.SetItemsProcessed(state.iterations() * N);
+}
+
+void bm_accumulate_dynamic(benchmark::State& state) {
+    dynamic_circular_buffer<int64_t> buffer(state.range(0), 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(buffer.begin(), buffer.end(), int64_t(0)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void bm_accumulate_array(benchmark::State& state) {
+    std::unique_ptr<int64_t[]> buffer(new int64_t[state.range(0)]);
+    std::fill(buffer.get(), buffer.get() + state.range(0), 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(buffer.get(), buffer.get() + state.range(0), int64_t(0)));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_TEMPLATE(bm_accumulate_static, 4096);
+BENCHMARK_TEMPLATE(bm_accumulate_static, 4000);
+BENCHMARK(bm_accumulate_dynamic)->Arg(4096);
+BENCHMARK(bm_accumulate_array)->Arg(4096);
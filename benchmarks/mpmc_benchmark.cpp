@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <thread>
+#include "../mpmc_circular_buffer.h"
+#include "mutex_circular_buffer.h"
+
+constexpr size_t shared_queue_size = 1024;
+constexpr size_t bulk_size = 32;
+
+template <class Queue>
+Queue* shared_queue = nullptr;
+
+template <class Queue>
+void bm_enqueue_dequeue(benchmark::State& state) {
+    if (state.thread_index() == 0)
+        shared_queue<Queue> = new Queue;
+    int64_t val = 0;
+    for (auto _ : state) {
+        while (!shared_queue<Queue>->try_enqueue(val))
+            std::this_thread::yield();
+        while (!shared_queue<Queue>->try_dequeue(val))
+            std::this_thread::yield();
+    }
+    benchmark::DoNotOptimize(val);
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete shared_queue<Queue>;
+        shared_queue<Queue> = nullptr;
+    }
+}
+
+template <class Queue>
+void bm_bulk_enqueue_dequeue(benchmark::State& state) {
+    if (state.thread_index() == 0)
+        shared_queue<Queue> = new Queue;
+    int64_t items[bulk_size] = {};
+    for (auto _ : state) {
+        for (size_t done = 0; done != bulk_size; ) {
+            const size_t pushed = shared_queue<Queue>->try_enqueue_bulk(items + done, bulk_size - done);
+            if (pushed == 0)
+                std::this_thread::yield();
+            done += pushed;
+        }
+        for (size_t done = 0; done != bulk_size; ) {
+            const size_t popped = shared_queue<Queue>->try_dequeue_bulk(items + done, bulk_size - done);
+            if (popped == 0)
+                std::this_thread::yield();
+            done += popped;
+        }
+    }
+    benchmark::DoNotOptimize(items);
+    state.SetItemsProcessed(state.iterations() * bulk_size);
+    if (state.thread_index() == 0) {
+        delete shared_queue<Queue>;
+        shared_queue<Queue> = nullptr;
+    }
+}
+
+BENCHMARK_TEMPLATE(bm_enqueue_dequeue, mpmc_circular_buffer<int64_t, shared_queue_size>)
+    ->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_enqueue_dequeue, mutex_circular_buffer<int64_t, shared_queue_size>)
+    ->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_bulk_enqueue_dequeue, mpmc_circular_buffer<int64_t, shared_queue_size>)
+    ->ThreadRange(1, 16)->UseRealTime();
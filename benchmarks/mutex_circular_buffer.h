@@ -0,0 +1,32 @@
+#pragma once
+#include <mutex>
+#include "../circular_buffer.h"
+
+template <class T, size_t N>
+class mutex_circular_buffer {
+public:
+    bool try_push(const T& val) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffer.full())
+            return false;
+        m_buffer.push_back(val);
+        return true;
+    }
+    bool try_pop(T& val) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffer.empty())
+            return false;
+        val = std::move(m_buffer.front());
+        m_buffer.pop_front();
+        return true;
+    }
+    bool try_enqueue(const T& val) {
+        return try_push(val);
+    }
+    bool try_dequeue(T& val) {
+        return try_pop(val);
+    }
+private:
+    std::mutex m_mutex;
+    circular_buffer<T, N> m_buffer;
+};
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include "../circular_buffer.h"
+
+constexpr size_t buffer_size = size_t(1) << 24;
+
+using buffer_type = circular_buffer<uint32_t, buffer_size>;
+
+// a buffer that has wrapped, filled with a fixed pseudo random sequence
+void refill(buffer_type& buffer) {
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i != buffer_size + buffer_size / 3; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buffer.push_back(x);
+    }
+}
+
+template <class Policy>
+void bm_sort(benchmark::State& state, Policy policy) {
+    auto buffer = std::make_unique<buffer_type>();
+    for (auto _ : state) {
+        state.PauseTiming();
+        refill(*buffer);
+        state.ResumeTiming();
+        std::sort(policy, buffer->begin(), buffer->end());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+}
+
+template <class Policy>
+void bm_nth_element(benchmark::State& state, Policy policy) {
+    auto buffer = std::make_unique<buffer_type>();
+    for (auto _ : state) {
+        state.PauseTiming();
+        refill(*buffer);
+        state.ResumeTiming();
+        std::nth_element(policy, buffer->begin(), buffer->begin() + buffer_size / 2, buffer->end());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+}
+
+template <class Policy>
+void bm_transform_reduce(benchmark::State& state, Policy policy) {
+    auto buffer = std::make_unique<buffer_type>();
+    refill(*buffer);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::transform_reduce(policy, buffer->cbegin(), buffer->cend(), uint64_t(0), std::plus<>(),
+            [](uint32_t x) { return uint64_t(x) * x; }));
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+}
+
+BENCHMARK_CAPTURE(bm_sort, seq, std::execution::seq)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(bm_sort, par, std::execution::par)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(bm_nth_element, seq, std::execution::seq)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(bm_nth_element, par, std::execution::par)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(bm_transform_reduce, seq, std::execution::seq)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(bm_transform_reduce, par_unseq, std::execution::par_unseq)->Unit(benchmark::kMillisecond)->UseRealTime();
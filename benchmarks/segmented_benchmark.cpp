@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "../circular_buffer.h"
+#include "../segmented_algorithms.h"
+
+constexpr size_t buffer_size = 1 << 16;
+
+// a buffer that has wrapped, so every range over it has two pieces
+template <class T>
+void fill_wrapped(circular_buffer<T, buffer_size>& buffer) {
+    for (size_t i = 0; i != buffer_size + buffer_size / 3; ++i)
+        buffer.push_back(T(i % 100));
+}
+
+template <class T, bool Segmented>
+void bm_copy_out(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    std::vector<T> out(buffer_size);
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            copy(buffer.cbegin(), buffer.cend(), out.data());
+        else
+            std::copy(buffer.cbegin(), buffer.cend(), out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+template <class T, bool Segmented>
+void bm_copy_in(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    const std::vector<T> in(buffer_size, T(1));
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            copy(in.data(), in.data() + in.size(), buffer.begin());
+        else
+            std::copy(in.data(), in.data() + in.size(), buffer.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+template <class T, bool Segmented>
+void bm_fill(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            fill(buffer.begin(), buffer.end(), T(1));
+        else
+            std::fill(buffer.begin(), buffer.end(), T(1));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+template <class T, bool Segmented>
+void bm_find(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    buffer.back() = T(127);
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            benchmark::DoNotOptimize(find(buffer.cbegin(), buffer.cend(), T(127)));
+        else
+            benchmark::DoNotOptimize(std::find(buffer.cbegin(), buffer.cend(), T(127)));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+template <class T, bool Segmented>
+void bm_equal(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    const std::vector<T> other(buffer.cbegin(), buffer.cend());
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            benchmark::DoNotOptimize(equal(buffer.cbegin(), buffer.cend(), other.data()));
+        else
+            benchmark::DoNotOptimize(std::equal(buffer.cbegin(), buffer.cend(), other.data()));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+template <class T, bool Segmented>
+void bm_accumulate(benchmark::State& state) {
+    circular_buffer<T, buffer_size> buffer;
+    fill_wrapped(buffer);
+    for (auto _ : state) {
+        if constexpr (Segmented)
+            benchmark::DoNotOptimize(accumulate(buffer.cbegin(), buffer.cend(), T(0)));
+        else
+            benchmark::DoNotOptimize(std::accumulate(buffer.cbegin(), buffer.cend(), T(0)));
+    }
+    state.SetBytesProcessed(state.iterations() * buffer_size * sizeof(T));
+}
+
+#define SEGMENTED_BENCHMARK(name, type) \
+    BENCHMARK_TEMPLATE(name, type, false); \
+    BENCHMARK_TEMPLATE(name, type, true)
+
+SEGMENTED_BENCHMARK(bm_copy_out, int);
+SEGMENTED_BENCHMARK(bm_copy_out, double);
+SEGMENTED_BENCHMARK(bm_copy_in, int);
+SEGMENTED_BENCHMARK(bm_fill, char);
+SEGMENTED_BENCHMARK(bm_fill, int);
+SEGMENTED_BENCHMARK(bm_find, char);
+SEGMENTED_BENCHMARK(bm_find, int);
+SEGMENTED_BENCHMARK(bm_equal, int);
+SEGMENTED_BENCHMARK(bm_accumulate, int);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "../circular_buffer.h"
+#include "../seqlock_circular_buffer.h"
+
+constexpr size_t ring_size = 1024;
+constexpr size_t window = 64;
+
+struct sample {
+    int64_t sequence;
+    double values[3];
+};
+
+// the same telemetry ring behind a mutex, what the readers used before
+class mutex_telemetry {
+public:
+    void push(const sample& val) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffer.push_back(val);
+    }
+    size_t snapshot(sample* out, size_t max) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t count = std::min(max, m_buffer.size());
+        std::copy(m_buffer.cend() - count, m_buffer.cend(), out);
+        return count;
+    }
+private:
+    std::mutex m_mutex;
+    circular_buffer<sample, ring_size> m_buffer;
+};
+
+template <class Ring>
+void bm_push(benchmark::State& state) {
+    Ring ring;
+    int64_t i = 0;
+    for (auto _ : state)
+        ring.push(sample{ i++, {} });
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <class Ring>
+Ring* shared_ring = nullptr;
+std::atomic<bool> writer_done{ false };
+std::thread writer;
+
+// every benchmark thread takes snapshots of the newest window while one writer pushes
+template <class Ring>
+void bm_snapshot(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        shared_ring<Ring> = new Ring;
+        writer_done = false;
+        writer = std::thread([ring = shared_ring<Ring>]() {
+            for (int64_t i = 0; !writer_done.load(std::memory_order_relaxed); ++i) {
+                ring->push(sample{ i, {} });
+                if (i % 256 == 0)
+                    std::this_thread::yield();
+            }
+        });
+    }
+    sample out[window];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shared_ring<Ring>->snapshot(out, window));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * window);
+    if (state.thread_index() == 0) {
+        writer_done = true;
+        writer.join();
+        delete shared_ring<Ring>;
+        shared_ring<Ring> = nullptr;
+    }
+}
+
+BENCHMARK_TEMPLATE(bm_push, seqlock_circular_buffer<sample, ring_size>);
+BENCHMARK_TEMPLATE(bm_push, mutex_telemetry);
+BENCHMARK_TEMPLATE(bm_snapshot, seqlock_circular_buffer<sample, ring_size>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_snapshot, mutex_telemetry)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include "../circular_buffer.h"
+#include "../simd_reductions.h"
+
+constexpr size_t window_size = 1 << 16;
+
+template <class T>
+circular_buffer<T, window_size>& wrapped_window() {
+    static circular_buffer<T, window_size> buffer = [] {
+        circular_buffer<T, window_size> result;
+        for (size_t i = 0; i != window_size + window_size / 3; ++i)
+            result.push_back(T(i % 1000));
+        return result;
+    }();
+    return buffer;
+}
+
+template <class T>
+void bm_sum_accumulate(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(buffer.cbegin(), buffer.cend(), T()));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+template <class T>
+void bm_min_element(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(*std::min_element(buffer.cbegin(), buffer.cend()));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+template <class T>
+void bm_dot_inner_product(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::inner_product(buffer.cbegin(), buffer.cend(), buffer.cbegin(), T()));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+// the argument is the simd_level
+template <class T>
+void bm_window_sum(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    const simd_level level = simd_level(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(window_sum(buffer, level));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+template <class T>
+void bm_window_min(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    const simd_level level = simd_level(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(window_min(buffer, level));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+template <class T>
+void bm_window_max(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    const simd_level level = simd_level(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(window_max(buffer, level));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+template <class T>
+void bm_window_dot(benchmark::State& state) {
+    const auto& buffer = wrapped_window<T>();
+    const simd_level level = simd_level(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(window_dot(buffer, buffer, level));
+    state.SetItemsProcessed(state.iterations() * window_size);
+}
+
+#define SIMD_BENCHMARK(name, type) \
+    BENCHMARK_TEMPLATE(name, type)->DenseRange(int(simd_level::scalar), int(simd_level::avx512))
+
+BENCHMARK_TEMPLATE(bm_sum_accumulate, double);
+SIMD_BENCHMARK(bm_window_sum, double);
+BENCHMARK_TEMPLATE(bm_min_element, double);
+SIMD_BENCHMARK(bm_window_min, double);
+SIMD_BENCHMARK(bm_window_max, double);
+BENCHMARK_TEMPLATE(bm_dot_inner_product, double);
+SIMD_BENCHMARK(bm_window_dot, double);
+BENCHMARK_TEMPLATE(bm_sum_accumulate, float);
+SIMD_BENCHMARK(bm_window_sum, float);
+BENCHMARK_TEMPLATE(bm_sum_accumulate, int32_t);
+SIMD_BENCHMARK(bm_window_sum, int32_t);
+BENCHMARK_TEMPLATE(bm_min_element, int16_t);
+SIMD_BENCHMARK(bm_window_min, int16_t);
@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include "../circular_buffer.h"
+#include "../soa_circular_buffer.h"
+
+constexpr size_t buffer_size = 1 << 16;
+
+struct tick {
+    int64_t timestamp;
+    double price;
+    double size;
+    uint32_t flags;
+};
+
+void bm_price_sum_aos(benchmark::State& state) {
+    circular_buffer<tick, buffer_size> buffer;
+    for (size_t i = 0; i != buffer_size + buffer_size / 2; ++i)
+        buffer.push_back(tick{ int64_t(i), double(i), 1.0, 0 });
+    for (auto _ : state) {
+        double sum = 0;
+        for (const tick& t : buffer)
+            sum += t.price;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+}
+
+void bm_price_sum_soa(benchmark::State& state) {
+    soa_circular_buffer<std::tuple<int64_t, double, double, uint32_t>, buffer_size> buffer;
+    for (size_t i = 0; i != buffer_size + buffer_size / 2; ++i)
+        buffer.push_back(int64_t(i), double(i), 1.0, 0u);
+    for (auto _ : state) {
+        std::span<const double> one = std::as_const(buffer).array_one<1>();
+        std::span<const double> two = std::as_const(buffer).array_two<1>();
+        double sum = std::accumulate(one.begin(), one.end(), 0.0);
+        sum = std::accumulate(two.begin(), two.end(), sum);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * buffer_size);
+}
+
+BENCHMARK(bm_price_sum_aos);
+BENCHMARK(bm_price_sum_soa);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <thread>
+#include "../spsc_circular_buffer.h"
+#include "mutex_circular_buffer.h"
+
+constexpr size_t queue_size = 1024;
+
+template <class Queue>
+void bm_throughput(benchmark::State& state) {
+    const int64_t count = state.range(0);
+    for (auto _ : state) {
+        Queue queue;
+        std::thread consumer([&queue, count]() {
+            int64_t val;
+            for (int64_t i = 0; i < count; ++i) {
+                while (!queue.try_pop(val))
+                    std::this_thread::yield();
+                benchmark::DoNotOptimize(val);
+            }
+        });
+        for (int64_t i = 0; i < count; ++i)
+            while (!queue.try_push(i))
+                std::this_thread::yield();
+        consumer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <class Queue>
+void bm_round_trip(benchmark::State& state) {
+    Queue ping;
+    Queue pong;
+    std::atomic<bool> stop = false;
+    std::thread echo([&]() {
+        int64_t val;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!ping.try_pop(val)) {
+                std::this_thread::yield();
+                continue;
+            }
+            while (!pong.try_push(val))
+                std::this_thread::yield();
+        }
+    });
+    int64_t val = 0;
+    for (auto _ : state) {
+        while (!ping.try_push(val))
+            std::this_thread::yield();
+        while (!pong.try_pop(val))
+            std::this_thread::yield();
+    }
+    stop = true;
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(bm_throughput, spsc_circular_buffer<int64_t, queue_size>)
+    ->Arg(1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_throughput, mutex_circular_buffer<int64_t, queue_size>)
+    ->Arg(1 << 20)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(bm_round_trip, spsc_circular_buffer<int64_t, queue_size>)->UseRealTime();
+BENCHMARK_TEMPLATE(bm_round_trip, mutex_circular_buffer<int64_t, queue_size>)->UseRealTime();
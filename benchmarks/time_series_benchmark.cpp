@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include "../time_series_buffer.h"
+
+constexpr size_t event_count = 1 << 20;
+
+// a full ring of events one microsecond apart that has wrapped
+time_series_buffer<int64_t, double, overwrite_oldest>& events() {
+    static time_series_buffer<int64_t, double, overwrite_oldest> buffer = [] {
+        time_series_buffer<int64_t, double, overwrite_oldest> result(event_count);
+        for (size_t i = 0; i != event_count + event_count / 3; ++i)
+            result.push(int64_t(i), double(i));
+        return result;
+    }();
+    return buffer;
+}
+
+// the argument is the length of the queried interval
+void bm_range_linear(benchmark::State& state) {
+    const auto& buffer = events();
+    const int64_t oldest = buffer.front().first;
+    int64_t from = oldest;
+    for (auto _ : state) {
+        const int64_t to = from + state.range(0);
+        auto first = std::find_if(buffer.cbegin(), buffer.cend(), [from](const auto& event) { return event.first >= from; });
+        auto last = std::find_if(first, buffer.cend(), [to](const auto& event) { return event.first >= to; });
+        benchmark::DoNotOptimize(last - first);
+        from = oldest + (from - oldest + 7919) % int64_t(event_count);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void bm_range_binary(benchmark::State& state) {
+    const auto& buffer = events();
+    const int64_t oldest = buffer.front().first;
+    int64_t from = oldest;
+    for (auto _ : state) {
+        const auto range = buffer.range(from, from + state.range(0));
+        benchmark::DoNotOptimize(range.first.size() + range.second.size());
+        from = oldest + (from - oldest + 7919) % int64_t(event_count);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bm_range_linear)->Arg(100)->Arg(10000);
+BENCHMARK(bm_range_binary)->Arg(100)->Arg(10000);
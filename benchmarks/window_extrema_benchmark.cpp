@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include "../circular_buffer.h"
+#include "../window_extrema.h"
+
+double sample(size_t i) {
+    return 100.0 + double(i * 7919 % 1000) * 0.01;
+}
+
+// one tick: push a sample, then read the low and the high of the window
+template <size_t N>
+void bm_tick_rescan(benchmark::State& state) {
+    circular_buffer<double, N> buffer;
+    size_t i = 0;
+    for (; i != N; ++i)
+        buffer.push_back(sample(i));
+    for (auto _ : state) {
+        buffer.push_back(sample(i++));
+        auto low = std::min_element(buffer.cbegin(), buffer.cend());
+        auto high = std::max_element(buffer.cbegin(), buffer.cend());
+        benchmark::DoNotOptimize(*low);
+        benchmark::DoNotOptimize(*high);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <size_t N>
+void bm_tick_monotonic(benchmark::State& state) {
+    window_extrema<double, N> window;
+    size_t i = 0;
+    for (; i != N; ++i)
+        window.push(sample(i));
+    for (auto _ : state) {
+        window.push(sample(i++));
+        benchmark::DoNotOptimize(window.window_min());
+        benchmark::DoNotOptimize(window.window_max());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(bm_tick_rescan, 64);
+BENCHMARK_TEMPLATE(bm_tick_monotonic, 64);
+BENCHMARK_TEMPLATE(bm_tick_rescan, 4096);
+BENCHMARK_TEMPLATE(bm_tick_monotonic, 4096);
+BENCHMARK_TEMPLATE(bm_tick_rescan, 65536);
+BENCHMARK_TEMPLATE(bm_tick_monotonic, 65536);
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include "../circular_buffer.h"
+#include "../window_stats.h"
+
+constexpr size_t window_size = 1 << 16;
+
+double sample(size_t i) {
+    return 100.0 + double(i * 7919 % 1000) * 0.01;
+}
+
+// one tick: push a sample, then read sum, mean and variance of the window
+void bm_tick_rescan(benchmark::State& state) {
+    circular_buffer<double, window_size> buffer;
+    size_t i = 0;
+    for (; i != window_size; ++i)
+        buffer.push_back(sample(i));
+    for (auto _ : state) {
+        buffer.push_back(sample(i++));
+        const double sum = std::accumulate(buffer.cbegin(), buffer.cend(), 0.0);
+        const double mean = sum / buffer.size();
+        double m2 = 0;
+        for (auto it = buffer.cbegin(); it != buffer.cend(); ++it)
+            m2 += (*it - mean) * (*it - mean);
+        benchmark::DoNotOptimize(sum);
+        benchmark::DoNotOptimize(m2 / buffer.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void bm_tick_incremental(benchmark::State& state) {
+    window_stats<double, window_size> stats;
+    size_t i = 0;
+    for (; i != window_size; ++i)
+        stats.push(sample(i));
+    for (auto _ : state) {
+        stats.push(sample(i++));
+        benchmark::DoNotOptimize(stats.sum());
+        benchmark::DoNotOptimize(stats.mean());
+        benchmark::DoNotOptimize(stats.variance());
+        benchmark::DoNotOptimize(stats.ewma());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bm_tick_rescan);
+BENCHMARK(bm_tick_incremental);
@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "circular_buffer.h"
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Bounded queue whose consumers park on a futex instead of polling. A producer only makes the
+// wake syscall when a consumer is parked and has not been woken yet, and then only on the empty
+// to non-empty transition or once batch_threshold elements have piled up; a consumer that leaves
+// elements behind wakes the next parked one itself. A consumer that asks for a batch holds back
+// a partial one until it reaches batch_threshold or has waited max_linger, so a steady trickle
+// costs at most two wakes per batch instead of one per element.
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class blocking_circular_queue {
+public:
+    using value_type = T;
+    using clock = std::chrono::steady_clock;
+
+    explicit blocking_circular_queue(size_t batch_threshold = 1, clock::duration max_linger = std::chrono::microseconds(100))
+        : m_batch_threshold(batch_threshold), m_max_linger(max_linger) {
+        if (batch_threshold == 0)
+            throw std::invalid_argument("batch threshold must be greater than 0");
+    }
+    blocking_circular_queue(const blocking_circular_queue&) = delete;
+    blocking_circular_queue& operator =(const blocking_circular_queue&) = delete;
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_buffer.full())
+            park(lock, m_not_full, m_waiting_producers, clock::time_point::max());
+        m_buffer.emplace_back(std::forward<Args>(args)...);
+        pushed(lock);
+    }
+    void push(T&& val) {
+        emplace(std::move(val));
+    }
+    void push(const T& val) {
+        emplace(val);
+    }
+    bool try_push(const T& val) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_buffer.full())
+            return false;
+        m_buffer.push_back(val);
+        pushed(lock);
+        return true;
+    }
+
+    T pop() {
+        T val;
+        take(&val, 1, clock::time_point::max());
+        return val;
+    }
+    bool try_pop(T& val) {
+        return take(&val, 1, clock::time_point::min()) != 0;
+    }
+    template <class Rep, class Period>
+    bool pop_for(T& val, const std::chrono::duration<Rep, Period>& timeout) {
+        return take(&val, 1, clock::now() + timeout) != 0;
+    }
+    // waits for the first element and for the batch to fill up, then takes everything available up to max
+    template <class OutputIt>
+    size_t pop_batch(OutputIt out, size_t max) {
+        return max == 0 ? 0 : take(out, max, clock::time_point::max());
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_buffer.size();
+    }
+    bool empty() const {
+        return size() == 0;
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    size_t batch_threshold() const noexcept {
+        return m_batch_threshold;
+    }
+    clock::duration max_linger() const noexcept {
+        return m_max_linger;
+    }
+    // how often parked consumers were woken
+    size_t consumer_wakeups() const noexcept {
+        return m_not_empty.load(std::memory_order_relaxed);
+    }
+
+private:
+    void pushed(std::unique_lock<std::mutex>& lock) {
+        const size_t size = m_buffer.size();
+        // parked consumers that were already woken will see the new elements once they run
+        const bool wake = m_waiting_consumers != 0 && !m_consumers_woken && (size == 1 || size >= m_batch_threshold);
+        if (wake) {
+            m_not_empty.fetch_add(1, std::memory_order_relaxed);
+            m_consumers_woken = true;
+        }
+        lock.unlock();
+        if (wake)
+            wake_all(m_not_empty);
+    }
+
+    template <class OutputIt>
+    size_t take(OutputIt out, size_t max, clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const size_t batch = std::min({ max, m_batch_threshold, N });
+        clock::time_point linger_end = clock::time_point::max();
+        while (m_buffer.size() < batch) {
+            const clock::time_point now = clock::now();
+            // the lingering starts once the first element is there, the producers wake the
+            // consumer again only when the batch is full
+            if (!m_buffer.empty() && linger_end == clock::time_point::max())
+                linger_end = now + m_max_linger;
+            const clock::time_point wake_by = std::min(deadline, linger_end);
+            if (now >= wake_by)
+                break;
+            park(lock, m_not_empty, m_waiting_consumers, wake_by);
+            m_consumers_woken = false;
+        }
+        if (m_buffer.empty())
+            return 0;
+        const bool was_full = m_buffer.full();
+        size_t n = 0;
+        for (; n != max && !m_buffer.empty(); ++n, ++out) {
+            *out = std::move(m_buffer.front());
+            m_buffer.pop_front();
+        }
+        const bool wake = was_full && m_waiting_producers != 0;
+        if (wake)
+            m_not_full.fetch_add(1, std::memory_order_relaxed);
+        // a consumer that parked while this one was being woken missed the wake the pushes
+        // skipped, so whatever this one leaves behind is handed on
+        const bool pass_on = !m_buffer.empty() && m_waiting_consumers != 0;
+        if (pass_on) {
+            m_not_empty.fetch_add(1, std::memory_order_relaxed);
+            m_consumers_woken = true;
+        }
+        lock.unlock();
+        if (wake)
+            wake_all(m_not_full);
+        if (pass_on)
+            wake_all(m_not_empty);
+        return n;
+    }
+
+    // sleeps until the signal is bumped, returns false on timeout
+    static bool park(std::unique_lock<std::mutex>& lock, std::atomic<uint32_t>& signal, size_t& waiting, clock::time_point deadline) {
+        const uint32_t seen = signal.load(std::memory_order_relaxed);
+        ++waiting;
+        lock.unlock();
+        const bool woken = wait(signal, seen, deadline);
+        lock.lock();
+        --waiting;
+        return woken;
+    }
+
+#if defined(__linux__)
+    static bool wait(std::atomic<uint32_t>& signal, uint32_t seen, clock::time_point deadline) {
+        while (signal.load(std::memory_order_relaxed) == seen) {
+            timespec timeout{};
+            timespec* timeout_ptr = nullptr;
+            if (deadline != clock::time_point::max()) {
+                const auto left = deadline - clock::now();
+                if (left <= clock::duration::zero())
+                    return false;
+                const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+                timeout.tv_sec = static_cast<time_t>(ns / 1000000000);
+                timeout.tv_nsec = static_cast<long>(ns % 1000000000);
+                timeout_ptr = &timeout;
+            }
+            syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAIT_PRIVATE, seen, timeout_ptr, nullptr, 0);
+        }
+        return true;
+    }
+    static void wake_all(std::atomic<uint32_t>& signal) noexcept {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    static bool wait(std::atomic<uint32_t>& signal, uint32_t seen, clock::time_point deadline) {
+        if (deadline == clock::time_point::max()) {
+            signal.wait(seen, std::memory_order_relaxed);
+            return true;
+        }
+        // std::atomic has no timed wait
+        while (signal.load(std::memory_order_relaxed) == seen) {
+            if (clock::now() >= deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+    static void wake_all(std::atomic<uint32_t>& signal) noexcept {
+        signal.notify_all();
+    }
+#endif
+
+    mutable std::mutex m_mutex;
+    circular_buffer<T, N, Alloc> m_buffer;
+    const size_t m_batch_threshold;
+    const clock::duration m_max_linger;
+    size_t m_waiting_consumers = 0;
+    size_t m_waiting_producers = 0;
+    bool m_consumers_woken = false;
+    std::atomic<uint32_t> m_not_empty{ 0 };
+    std::atomic<uint32_t> m_not_full{ 0 };
+};
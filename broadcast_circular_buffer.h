@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "cache_line.h"
+#include "full_policy.h"
+#include "seqlock_slot.h"
+
+// Ring with one writer whose every element is read by each of a fixed number of consumers.
+// Each consumer owns a cursor (the sequence number of the next element it reads), so a message
+// is stored once no matter how many consumers read it.
+//  - block_when_full: publish waits until the slowest consumer has read the slot it overwrites
+//  - reject_newest: publish returns false instead of waiting
+//  - overwrite_oldest: the writer never waits and laps slow consumers, which skip the entries
+//    they lost and count them in lapped(). Slots are then seqlocks, so T must be trivially copyable.
+template <class T, size_t N, class FullPolicy = block_when_full, class Alloc = std::allocator<T>>
+class broadcast_circular_buffer {
+    static constexpr bool lapping = std::is_same_v<FullPolicy, overwrite_oldest>;
+    static_assert(N > 0, "N must be greater than 0");
+    static_assert(lapping || std::is_same_v<FullPolicy, block_when_full> || std::is_same_v<FullPolicy, reject_newest>,
+        "broadcast_circular_buffer supports block_when_full, reject_newest and overwrite_oldest");
+
+    using slot = std::conditional_t<lapping, seqlock_slot<T>, T>;
+    using slot_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<slot>;
+
+    struct alignas(cache_line_size) cursor {
+        std::atomic<size_t> position{ 0 };
+        std::atomic<size_t> lapped{ 0 };
+    };
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    // entries a consumer can read in place, oldest first, split where the ring wraps
+    using range_type = std::pair<std::span<const T>, std::span<const T>>;
+
+    explicit broadcast_circular_buffer(size_t consumers, const Alloc& alloc = Alloc())
+        : m_allocator(alloc), m_consumer_count(consumers) {
+        if (consumers == 0)
+            throw std::invalid_argument("broadcast needs at least one consumer");
+        m_slots = std::allocator_traits<slot_allocator>::allocate(m_allocator, N);
+        if constexpr (lapping) {
+            for (size_t i = 0; i != N; ++i)
+                std::allocator_traits<slot_allocator>::construct(m_allocator, m_slots + i);
+        }
+        m_cursors = std::make_unique<cursor[]>(consumers);
+    }
+    broadcast_circular_buffer(const broadcast_circular_buffer&) = delete;
+    broadcast_circular_buffer& operator =(const broadcast_circular_buffer&) = delete;
+    ~broadcast_circular_buffer() noexcept {
+        if constexpr (lapping) {
+            for (size_t i = 0; i != N; ++i)
+                std::allocator_traits<slot_allocator>::destroy(m_allocator, m_slots + i);
+        }
+        else {
+            const size_t head = m_head.load(std::memory_order_acquire);
+            for (size_t i = head - std::min(head, N); i != head; ++i)
+                std::allocator_traits<slot_allocator>::destroy(m_allocator, m_slots + i % N);
+        }
+        std::allocator_traits<slot_allocator>::deallocate(m_allocator, m_slots, N);
+    }
+
+    // writer side, returns false when reject_newest finds the slowest consumer N entries behind
+    template <typename... Args>
+    bool publish(Args&&... args) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if constexpr (lapping) {
+            m_slots[head % N].store(T(std::forward<Args>(args)...), head);
+        }
+        else {
+            if (head - m_gate_cache == N) {
+                m_gate_cache = slowest();
+                while (head - m_gate_cache == N) {
+                    if constexpr (std::is_same_v<FullPolicy, reject_newest>)
+                        return false;
+                    std::this_thread::yield();
+                    m_gate_cache = slowest();
+                }
+            }
+            slot* target = m_slots + head % N;
+            if (head >= N) {
+                // every consumer is past the old element, nobody reads it any more
+                *target = T(std::forward<Args>(args)...);
+            }
+            else {
+                std::allocator_traits<slot_allocator>::construct(m_allocator, target, std::forward<Args>(args)...);
+            }
+        }
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, each consumer index is used by one thread at a time
+    size_t available(size_t consumer) const noexcept {
+        const size_t position = m_cursors[consumer].position.load(std::memory_order_relaxed);
+        return std::min(m_head.load(std::memory_order_acquire) - position, N);
+    }
+    bool try_read(size_t consumer, T& val) {
+        return read_batch(consumer, &val, 1) == 1;
+    }
+    // copies up to max available entries, oldest first
+    template <class OutputIt>
+    size_t read_batch(size_t consumer, OutputIt out, size_t max) {
+        cursor& own = m_cursors[consumer];
+        size_t position = own.position.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t count = 0;
+        if constexpr (lapping) {
+            T val;
+            for (; count != max && position != head; ++position) {
+                if (head - position > N || !m_slots[position % N].try_load(val, position)) {
+                    // the writer has reused the slot, everything older than its last N entries is lost
+                    head = m_head.load(std::memory_order_acquire);
+                    const size_t resume = std::max(position + 1, head - std::min(head, N));
+                    own.lapped.fetch_add(resume - position, std::memory_order_relaxed);
+                    position = resume - 1;
+                    continue;
+                }
+                *out = val;
+                ++out;
+                ++count;
+            }
+        }
+        else {
+            for (; count != max && position != head; ++position, ++count, ++out)
+                *out = m_slots[position % N];
+        }
+        own.position.store(position, std::memory_order_release);
+        return count;
+    }
+    // zero copy batch read: every available entry stays valid until consume releases it
+    range_type peek(size_t consumer) const noexcept requires (!lapping) {
+        const size_t position = m_cursors[consumer].position.load(std::memory_order_relaxed);
+        const size_t count = m_head.load(std::memory_order_acquire) - position;
+        const size_t first = std::min(count, N - position % N);
+        return { std::span<const T>(m_slots + position % N, first), std::span<const T>(m_slots, count - first) };
+    }
+    void consume(size_t consumer, size_t count) noexcept requires (!lapping) {
+        m_cursors[consumer].position.fetch_add(count, std::memory_order_release);
+    }
+    // entries the consumer lost to the writer
+    size_t lapped(size_t consumer) const noexcept {
+        return m_cursors[consumer].lapped.load(std::memory_order_relaxed);
+    }
+
+    // sequence number of the next published entry
+    size_t published() const noexcept {
+        return m_head.load(std::memory_order_acquire);
+    }
+    size_t consumers() const noexcept {
+        return m_consumer_count;
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+
+private:
+    size_t slowest() const noexcept {
+        size_t result = m_cursors[0].position.load(std::memory_order_acquire);
+        for (size_t i = 1; i != m_consumer_count; ++i)
+            result = std::min(result, m_cursors[i].position.load(std::memory_order_acquire));
+        return result;
+    }
+
+    [[no_unique_address]] slot_allocator m_allocator;
+    slot* m_slots = nullptr;
+    std::unique_ptr<cursor[]> m_cursors;
+    const size_t m_consumer_count;
+
+    // written by the writer, m_gate_cache is its private copy of the slowest cursor
+    alignas(cache_line_size) std::atomic<size_t> m_head{ 0 };
+    size_t m_gate_cache = 0;
+};
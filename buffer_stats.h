@@ -0,0 +1,128 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+struct buffer_stats_snapshot {
+    size_t pushes = 0;
+    size_t pops = 0;
+    // elements replaced before anyone popped them
+    size_t overwrites = 0;
+    // elements a reject_newest buffer refused
+    size_t drops = 0;
+    size_t reallocations = 0;
+    size_t bytes_moved = 0;
+    size_t high_water_mark = 0;
+};
+
+// The buffers call these hooks on every push and pop. no_stats is empty and every hook
+// is an inline no-op, so a buffer without statistics stays as it was.
+struct no_stats {
+    void pushed(size_t, size_t) noexcept {}
+    void popped(size_t) noexcept {}
+    void overwritten(size_t) noexcept {}
+    void dropped(size_t) noexcept {}
+    void reallocated(size_t) noexcept {}
+    buffer_stats_snapshot snapshot() const noexcept {
+        return {};
+    }
+    void reset() noexcept {}
+    void swap(no_stats&) noexcept {}
+};
+
+// Atomic counters are relaxed, for buffers that are pushed and popped from different threads.
+template <bool Atomic>
+class basic_buffer_stats {
+public:
+    basic_buffer_stats() = default;
+    // a copied buffer starts counting from zero
+    basic_buffer_stats(const basic_buffer_stats&) noexcept {}
+    basic_buffer_stats& operator =(const basic_buffer_stats&) noexcept {
+        return *this;
+    }
+
+    void pushed(size_t n, size_t size) noexcept {
+        add(m_pushes, n);
+        if constexpr (Atomic) {
+            size_t peak = m_high_water_mark.load(std::memory_order_relaxed);
+            while (peak < size && !m_high_water_mark.compare_exchange_weak(peak, size, std::memory_order_relaxed))
+                ;
+        }
+        else if (m_high_water_mark < size) {
+            m_high_water_mark = size;
+        }
+    }
+    void popped(size_t n) noexcept {
+        add(m_pops, n);
+    }
+    void overwritten(size_t n) noexcept {
+        add(m_overwrites, n);
+    }
+    void dropped(size_t n) noexcept {
+        add(m_drops, n);
+    }
+    void reallocated(size_t bytes) noexcept {
+        add(m_reallocations, 1);
+        add(m_bytes_moved, bytes);
+    }
+
+    buffer_stats_snapshot snapshot() const noexcept {
+        buffer_stats_snapshot result;
+        result.pushes = load(m_pushes);
+        result.pops = load(m_pops);
+        result.overwrites = load(m_overwrites);
+        result.drops = load(m_drops);
+        result.reallocations = load(m_reallocations);
+        result.bytes_moved = load(m_bytes_moved);
+        result.high_water_mark = load(m_high_water_mark);
+        return result;
+    }
+    void reset() noexcept {
+        for (counter* it : { &m_pushes, &m_pops, &m_overwrites, &m_drops, &m_reallocations, &m_bytes_moved, &m_high_water_mark }) {
+            if constexpr (Atomic)
+                it->store(0, std::memory_order_relaxed);
+            else
+                *it = 0;
+        }
+    }
+    // follows the elements when two buffers are swapped, not atomic as a whole
+    void swap(basic_buffer_stats& other) noexcept {
+        counter* mine[] = { &m_pushes, &m_pops, &m_overwrites, &m_drops, &m_reallocations, &m_bytes_moved, &m_high_water_mark };
+        counter* theirs[] = { &other.m_pushes, &other.m_pops, &other.m_overwrites, &other.m_drops, &other.m_reallocations, &other.m_bytes_moved, &other.m_high_water_mark };
+        for (size_t i = 0; i != std::size(mine); ++i) {
+            if constexpr (Atomic)
+                mine[i]->store(theirs[i]->exchange(mine[i]->load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+            else
+                std::swap(*mine[i], *theirs[i]);
+        }
+    }
+
+private:
+    using counter = std::conditional_t<Atomic, std::atomic<size_t>, size_t>;
+
+    static void add(counter& value, size_t n) noexcept {
+        if constexpr (Atomic)
+            value.fetch_add(n, std::memory_order_relaxed);
+        else
+            value += n;
+    }
+    static size_t load(const counter& value) noexcept {
+        if constexpr (Atomic)
+            return value.load(std::memory_order_relaxed);
+        else
+            return value;
+    }
+
+    counter m_pushes{ 0 };
+    counter m_pops{ 0 };
+    counter m_overwrites{ 0 };
+    counter m_drops{ 0 };
+    counter m_reallocations{ 0 };
+    counter m_bytes_moved{ 0 };
+    counter m_high_water_mark{ 0 };
+};
+
+using buffer_stats = basic_buffer_stats<false>;
+using atomic_buffer_stats = basic_buffer_stats<true>;
@@ -0,0 +1,4 @@
+#pragma once
+#include <cstddef>
+
+constexpr size_t cache_line_size = 64;
@@ -1,12 +1,24 @@
 #pragma once
 #include <stdexcept>
 #include <initializer_list>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include "iterators.h"
+#include "full_policy.h"
+#include "buffer_stats.h"
 
-template <class T, size_t N, class Alloc = std::allocator<T>>
+template <class T, size_t N, class Alloc = std::allocator<T>, class FullPolicy = overwrite_oldest, class Stats = no_stats>
 class circular_buffer {
 public:
     static_assert(N > 0, "N must be greater than 0");
+    static_assert(!std::is_same_v<FullPolicy, grow_when_full>, "a buffer with a fixed capacity cannot grow");
 
     using value_type = T;
     using reference = T&;
@@ -16,12 +28,25 @@ public:
     using pointer = typename std::allocator_traits<Alloc>::pointer;
     using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
 
-    using iterator = circ_buff_iter<T>;
-    using const_iterator = circ_buff_const_iter<T>;
+    using iterator = circ_buff_iter<T, N>;
+    using const_iterator = circ_buff_const_iter<T, N>;
+
+    // the elements from a sequence number on, oldest first, split where the ring wraps.
+    // lost counts the requested elements that were already overwritten or popped.
+    struct replay_type {
+        std::span<const T> first;
+        std::span<const T> second;
+        uint64_t lost;
+
+        bool lapped() const noexcept {
+            return lost != 0;
+        }
+    };
 
     template <typename Iter>
     circular_buffer(Iter first, Iter last, const Alloc& alloc = Alloc()) : m_allocator(alloc)
-        , m_buffer(m_allocator.allocate(N)) , m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin) {
+        , m_buffer(m_allocator.allocate(N)) , m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin)
+        , m_tail(m_begin), m_size(0) {
         if (std::distance(first, last) > N || std::distance(first, last) < 0) {
             m_allocator.deallocate(m_buffer, N);
             throw std::range_error("incorrect iterators");
@@ -36,21 +61,13 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
-        }
-        try {
-            for ( ; it != m_end; ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(T()));
-        }
-        catch (...) {
-            for (pointer del_it = m_begin; del_it != it; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
+        m_size = it - m_begin;
+        m_head = (it == m_end) ? m_begin : it;
     }
     circular_buffer(const T& val, const Alloc& alloc = Alloc()) : m_allocator(alloc), m_buffer(m_allocator.allocate(N))
-        , m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin) {
+        , m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin), m_tail(m_begin), m_size(N) {
         pointer it;
         try {
             for (it = m_begin; it != m_end; ++it)
@@ -60,11 +77,12 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     circular_buffer(const std::initializer_list<T> &list, const Alloc& alloc = Alloc()) : m_allocator(alloc)
-        , m_buffer(m_allocator.allocate(N)), m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin) {
+        , m_buffer(m_allocator.allocate(N)), m_begin(m_buffer), m_end(m_buffer + N), m_head(m_begin)
+        , m_tail(m_begin), m_size(list.size()) {
         if (list.size() > N) {
             m_allocator.deallocate(m_buffer, N);
             throw std::range_error("initializer list length is greater then size of bufffer");
@@ -79,57 +97,38 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
-        }
-        try {
-            for (; it != m_end; ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(T()));
-        }
-        catch (...) {
-            for (pointer del_it = m_begin; del_it != it; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
+        m_head = (it == m_end) ? m_begin : it;
     }
 
     circular_buffer(const Alloc& alloc = Alloc()) : m_allocator(alloc) , m_buffer(m_allocator.allocate(N))
-        , m_begin(m_buffer) , m_end(m_buffer + N) , m_head(m_begin) {
-        pointer it;
-        try {
-            for (it = m_begin; it != m_end; ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(T()));
-        }
-        catch (...) {
-            for (pointer del_it = m_begin; del_it != it; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
-        }
-    }
+        , m_begin(m_buffer) , m_end(m_buffer + N) , m_head(m_begin), m_tail(m_begin), m_size(0) {}
     circular_buffer(const circular_buffer& other)
         : m_allocator(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator))
         , m_buffer(m_allocator.allocate(N)), m_begin(m_buffer), m_end(m_buffer + N)
-        , m_head(m_begin + (other.m_head - other.m_begin)) {
+        , m_head(m_begin + other.m_size % N), m_tail(m_begin), m_size(other.m_size), m_first_seq(other.m_first_seq) {
         pointer it = m_begin;
         try {
-            for (const_pointer other_it = other.m_begin; other_it != other.m_end; ++other_it, ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(*other_it));
+            for (const_iterator other_it = other.cbegin(); other_it != other.cend(); ++other_it, ++it)
+                std::allocator_traits<Alloc>::construct(m_allocator, it, *other_it);
         }
         catch (...) {
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     circular_buffer(circular_buffer&& other) noexcept
         : m_allocator(std::move(other.m_allocator)), m_buffer(other.m_buffer)
-        , m_begin(other.m_begin), m_end(other.m_end), m_head(other.m_head) {
+        , m_begin(other.m_begin), m_end(other.m_end), m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size), m_first_seq(other.m_first_seq) {
         other.m_buffer = nullptr;
         other.m_begin = nullptr;
         other.m_end = nullptr;
         other.m_head = nullptr;
+        other.m_tail = nullptr;
+        other.m_size = 0;
     }
     circular_buffer& operator =(const circular_buffer& other) {
         Alloc new_allocator = std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator);
@@ -137,66 +136,123 @@ public:
             pointer new_buffer = new_allocator.allocate(N);
             pointer it = new_buffer;
             try {
-                for (const_pointer other_it = other.m_begin; other_it != other.m_end; ++other_it, ++it)
-                    std::allocator_traits<Alloc>::construct(new_allocator, it, std::move(*other_it));
+                for (const_iterator other_it = other.cbegin(); other_it != other.cend(); ++other_it, ++it)
+                    std::allocator_traits<Alloc>::construct(new_allocator, it, *other_it);
             }
             catch (...) {
                 for (pointer del_it = new_buffer; del_it != it; ++del_it)
                     std::allocator_traits<Alloc>::destroy(new_allocator, del_it);
                 new_allocator.deallocate(new_buffer, N);
-                throw std::exception("elements consctruction fail");
+                throw std::runtime_error("elements consctruction fail");
             }
-            for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
+            destroy_elements();
             m_allocator.deallocate(m_buffer, N);
 
             m_allocator = std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator);
             m_buffer = new_buffer;
             m_begin = new_buffer;
             m_end = new_buffer + N;
-            m_head = m_begin + (other.m_head - other.m_begin);
+            m_tail = m_begin;
+            m_head = m_begin + other.m_size % N;
+            m_size = other.m_size;
+            m_first_seq = other.m_first_seq;
         }
         return *this;
     }
     circular_buffer& operator =(circular_buffer&& other) noexcept {
-        for (pointer it = m_begin; it != m_end; ++it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, it);
-        m_allocator.deallocate(m_buffer, N);
+        if (m_buffer != nullptr) {
+            destroy_elements();
+            m_allocator.deallocate(m_buffer, N);
+        }
 
         m_allocator = std::move(other.m_allocator);
         m_buffer = other.m_buffer;
         m_begin = other.m_begin;
         m_end = other.m_end;
         m_head = other.m_head;
+        m_tail = other.m_tail;
+        m_size = other.m_size;
+        m_first_seq = other.m_first_seq;
         other.m_buffer = nullptr;
         other.m_begin = nullptr;
         other.m_end = nullptr;
         other.m_head = nullptr;
+        other.m_tail = nullptr;
+        other.m_size = 0;
         return *this;
     }
 
     iterator begin() noexcept {
-        return iterator(m_begin, 0, N);
+        return iterator(m_begin, m_tail - m_begin, N);
     }
     iterator end() noexcept {
-        return iterator(m_begin, N, N);
+        return iterator(m_begin, (m_tail - m_begin) + m_size, N);
+    }
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+    const_iterator end() const noexcept {
+        return cend();
     }
     const_iterator cbegin() const noexcept {
-        return const_iterator(m_begin, 0, N);
+        return const_iterator(m_begin, m_tail - m_begin, N);
     }
     const_iterator cend() const noexcept {
-        return const_iterator(m_begin, N, N);
+        return const_iterator(m_begin, (m_tail - m_begin) + m_size, N);
+    }
+
+    std::span<T> array_one() noexcept {
+        return std::span<T>(std::to_address(m_tail), wrapped() ? m_end - m_tail : m_size);
+    }
+    std::span<T> array_two() noexcept {
+        return std::span<T>(std::to_address(m_begin), wrapped() ? m_head - m_begin : 0);
+    }
+    std::span<const T> array_one() const noexcept {
+        return std::span<const T>(std::to_address(m_tail), wrapped() ? m_end - m_tail : m_size);
+    }
+    std::span<const T> array_two() const noexcept {
+        return std::span<const T>(std::to_address(m_begin), wrapped() ? m_head - m_begin : 0);
+    }
+    std::span<T> linearize() {
+        if (mirrored())
+            return array_one();
+        if (m_size == N) {
+            std::rotate(m_begin, m_tail, m_end);
+        }
+        else if (wrapped()) {
+            // close the free gap first, then everything between m_begin and the last element is constructed
+            move_left(m_tail, m_end, m_head);
+            std::rotate(m_begin, m_head, m_begin + m_size);
+        }
+        else {
+            move_left(m_tail, m_head, m_begin);
+        }
+        m_tail = m_begin;
+        m_head = m_begin + m_size % N;
+        return array_one();
     }
- 
+
     reference operator [](size_t offset) noexcept {
-        return m_buffer[offset];
+        return *slot(offset);
     }
     reference at(size_t offset) {
-        if (offset >= N)
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return *slot(offset);
+    }
+    const_reference operator [](size_t offset) const noexcept {
+        return *slot(offset);
+    }
+    const_reference at(size_t offset) const {
+        if (offset >= m_size)
             throw std::out_of_range("Index of out range");
-        return m_buffer[offset];
+        return *slot(offset);
     }
-    size_t size() const noexcept {
+    size_t size() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_size;
+    }
+    size_t capacity() const noexcept {
         return N;
     }
     size_t max_size() const noexcept {
@@ -204,10 +260,56 @@ public:
     }
 
     reference front() noexcept {
-        return m_buffer[0];
+        return *m_tail;
     }
     reference back() noexcept {
-        return m_buffer[N - 1];
+        return *slot(m_size - 1);
+    }
+    const_reference front() const noexcept {
+        return *m_tail;
+    }
+    const_reference back() const noexcept {
+        return *slot(m_size - 1);
+    }
+
+    // Every stored element is numbered in push order, the numbers survive overwrites, pops and
+    // clear(). Only pop_back hands the number of the element it removes to the next push.
+    uint64_t oldest_seq() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_first_seq;
+    }
+    // oldest_seq() - 1 while the buffer is empty
+    uint64_t newest_seq() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_first_seq + m_size - 1;
+    }
+    // the number the next pushed element gets
+    uint64_t next_seq() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_first_seq + m_size;
+    }
+    reference at_seq(uint64_t seq) {
+        if (seq - m_first_seq >= m_size)
+            throw std::out_of_range("sequence number is not in the buffer");
+        return *slot(seq - m_first_seq);
+    }
+    const_reference at_seq(uint64_t seq) const {
+        if (seq - m_first_seq >= m_size)
+            throw std::out_of_range("sequence number is not in the buffer");
+        return *slot(seq - m_first_seq);
+    }
+    // a reader that has consumed everything before seq resumes here; a seq past the newest
+    // element gives empty views
+    replay_type read_from(uint64_t seq) const noexcept {
+        const uint64_t lost = seq < m_first_seq ? m_first_seq - seq : 0;
+        const uint64_t offset = seq + lost - m_first_seq;
+        const std::span<const T> one = array_one();
+        const std::span<const T> two = array_two();
+        if (offset >= m_size)
+            return { {}, {}, lost };
+        if (offset >= one.size())
+            return { two.subspan(offset - one.size()), {}, lost };
+        return { one.subspan(offset), two, lost };
     }
 
     template <typename Iter>
@@ -232,7 +334,7 @@ public:
         catch (...) {
             std::allocator_traits<Alloc>::destroy(m_allocator, std::addressof(*it));
             std::allocator_traits<Alloc>::construct(m_allocator, std::addressof(*it), std::forward<T>(temp));
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     void insert(iterator it, size_t n, T&& val) {
@@ -245,29 +347,94 @@ public:
             if (it == this->end())
                 it = this->begin();
         }
-    } 
+    }
 
+    // returns false if FullPolicy rejected the element
     template <typename... Args>
-    void emplace_back(Args&&... args) {
-        T temp = std::move(*m_head);
-        try {
-            std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
-            std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::forward<Args>(args)...);
+    bool emplace_back(Args&&... args) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == N) {
+            if constexpr (std::is_same_v<FullPolicy, reject_newest>) {
+                m_stats.dropped(1);
+                return false;
+            }
+            else if constexpr (std::is_same_v<FullPolicy, block_when_full>) {
+                m_policy.wait(lock, [this] { return m_size != N; });
+            }
+            else {
+                // built before touching the oldest slot, so args may refer to it
+                *m_head = T(std::forward<Args>(args)...);
+                m_tail = next(m_tail);
+                m_head = next(m_head);
+                ++m_first_seq;
+                m_stats.overwritten(1);
+                m_stats.pushed(1, N);
+                return true;
+            }
         }
-        catch (...) {
-            std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
-            std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::move(temp));
-            throw std::exception("elements consctruction fail");
+        std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::forward<Args>(args)...);
+        ++m_size;
+        m_head = next(m_head);
+        m_stats.pushed(1, m_size);
+        return true;
+    }
+    bool push_back(T&& val) {
+        return emplace_back(std::move(val));
+    }
+    bool push_back(const T& val) {
+        return emplace_back(val);
+    }
+    // returns how many of the elements are in the buffer afterwards
+    template <typename Iter>
+    size_t push_back(Iter first, Iter last) {
+        // write() hands block_when_full back here, it takes the element loop below
+        if constexpr (std::contiguous_iterator<Iter> && std::is_same_v<std::iter_value_t<Iter>, T> && !std::is_same_v<FullPolicy, block_when_full>) {
+            return write(std::to_address(first), last - first);
+        }
+        else if constexpr (std::forward_iterator<Iter> && !std::is_same_v<FullPolicy, block_when_full>) {
+            size_t n = std::distance(first, last);
+            std::advance(first, make_room(n));
+            store(first, n);
+            return n;
+        }
+        else {
+            size_t count = 0;
+            for (; first != last && emplace_back(*first); ++first)
+                ++count;
+            return count;
         }
-        ++m_head;
-        if (m_head == m_end)
-            m_head = m_begin;
     }
-    void push_back(T&& val) {
-        emplace_back(std::move(val));
+    size_t write(const T* data, size_t n) {
+        if constexpr (std::is_same_v<FullPolicy, block_when_full>) {
+            return push_back(data, data + n);
+        }
+        else {
+            data += make_room(n);
+            store(data, n);
+            return n;
+        }
     }
-    void push_back(const T& val) {
-        emplace_back(val);
+
+    void pop_front() {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        std::allocator_traits<Alloc>::destroy(m_allocator, m_tail);
+        m_tail = next(m_tail);
+        --m_size;
+        ++m_first_seq;
+        m_stats.popped(1);
+        m_policy.notify();
+    }
+    void pop_back() {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        m_head = (m_head == m_begin ? m_end : m_head) - 1;
+        std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
+        --m_size;
+        m_stats.popped(1);
+        m_policy.notify();
     }
 
     void swap(circular_buffer& other) noexcept {
@@ -278,38 +445,150 @@ public:
         std::swap(this->m_end, other.m_end);
         std::swap(this->m_buffer, other.m_buffer);
         std::swap(this->m_head, other.m_head);
+        std::swap(this->m_tail, other.m_tail);
+        std::swap(this->m_size, other.m_size);
+        std::swap(this->m_first_seq, other.m_first_seq);
+        m_stats.swap(other.m_stats);
     }
-    void clear() {
-        for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-        pointer it;
-        try {
-            for (it = m_begin; it != m_end; ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(T()));
-        }
-        catch (...) {
-            for (pointer del_it = m_begin; del_it != it; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, N);
-            throw std::exception("elements consctruction fail");
-        }
-        m_head = m_begin;
+    void clear() noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        destroy_elements();
+        m_head = m_tail = m_begin;
+        m_first_seq += m_size;
+        m_size = 0;
+        m_policy.notify();
+    }
+    bool empty() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_size == 0;
+    }
+    bool full() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        return m_size == N;
+    }
+
+    buffer_stats_snapshot stats() const noexcept {
+        return m_stats.snapshot();
     }
-    bool empty() const noexcept {
-        return false;
+    void reset_stats() noexcept {
+        m_stats.reset();
     }
-    
+
     ~circular_buffer() noexcept {
         if (m_buffer == nullptr)
             return;
-        for(pointer it = m_begin; it != m_end; ++it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, it); 
+        destroy_elements();
         m_allocator.deallocate(m_buffer, N);
     }
 private:
+    // block_when_full's lock can throw std::system_error, the members that take it are only noexcept without it
+    static constexpr bool nothrow_lock = noexcept(std::declval<FullPolicy&>().lock());
+
+    pointer next(pointer it) const noexcept {
+        return (++it == m_end) ? m_begin : it;
+    }
+    pointer slot(size_t offset) const noexcept {
+        const size_t index = (m_tail - m_begin) + offset;
+        return m_begin + (index < N ? index : index - N);
+    }
+    // storage that is mapped twice in a row never wraps as far as the spans are concerned
+    bool wrapped() const noexcept {
+        return m_size != 0 && m_head <= m_tail && !mirrored();
+    }
+    bool mirrored() const noexcept {
+        if constexpr (requires(const Alloc& a) { a.is_mirrored(m_buffer, N); })
+            return m_buffer != nullptr && m_allocator.is_mirrored(m_buffer, N);
+        else
+            return false;
+    }
+    void destroy_elements() noexcept {
+        pointer it = m_tail;
+        for (size_t i = 0; i != m_size; ++i, it = next(it))
+            std::allocator_traits<Alloc>::destroy(m_allocator, it);
+    }
+
+    // moves [first, last) down to dest, where [dest, first) holds no elements
+    void move_left(pointer first, pointer last, pointer dest) {
+        if (dest == first)
+            return;
+        pointer it = dest;
+        for (pointer src = first; src != last; ++src, ++it) {
+            if (it < first)
+                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(*src));
+            else
+                *it = std::move(*src);
+        }
+        for (pointer del_it = std::max(it, first); del_it != last; ++del_it)
+            std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
+    }
+
+    // trims n to the elements that get stored, returns how many leading elements are skipped.
+    // Under overwrite_oldest store() replaces the oldest elements itself.
+    size_t make_room(size_t& n) noexcept {
+        if constexpr (std::is_same_v<FullPolicy, reject_newest>) {
+            m_stats.dropped(n - std::min(n, N - m_size));
+            n = std::min(n, N - m_size);
+        }
+        else if (n >= N) {
+            const size_t skip = n - N;
+            m_stats.pushed(skip, m_size);
+            m_stats.overwritten(m_size + skip);
+            this->clear();
+            m_first_seq += skip;
+            n = N;
+            return skip;
+        }
+        return 0;
+    }
+
+    // stores n <= N elements at m_head, constructing free slots and overwriting the oldest ones
+    template <typename Iter>
+    void store(Iter first, size_t n) {
+        const size_t free_slots = N - m_size;
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_same_v<Iter, const T*>) {
+            // branching on the split, rather than clamping it, lets GCC see both sizes are in range
+            const size_t room = m_end - m_head;
+            if (n <= room) {
+                if (n != 0)
+                    std::memcpy(std::to_address(m_head), first, n * sizeof(T));
+            }
+            else {
+                std::memcpy(std::to_address(m_head), first, room * sizeof(T));
+                std::memcpy(std::to_address(m_begin), first + room, (n - room) * sizeof(T));
+            }
+            const size_t head = (m_head - m_begin) + n;
+            m_head = m_begin + (head < N ? head : head - N);
+        }
+        else {
+            for (size_t i = 0; i != n; ++i, ++first) {
+                if (i < free_slots)
+                    std::allocator_traits<Alloc>::construct(m_allocator, m_head, *first);
+                else
+                    *m_head = *first;
+                m_head = next(m_head);
+            }
+        }
+        if (n > free_slots) {
+            m_tail = m_head;
+            m_size = N;
+            m_first_seq += n - free_slots;
+            m_stats.overwritten(n - free_slots);
+        }
+        else {
+            m_size += n;
+        }
+        m_stats.pushed(n, m_size);
+    }
+
     Alloc m_allocator;
     pointer m_buffer;
     pointer m_begin;
     pointer m_end;
     pointer m_head;
+    pointer m_tail;
+    size_t m_size;
+    // sequence number of the oldest element, every stored element gets the next one
+    uint64_t m_first_seq = 0;
+    [[no_unique_address]] mutable FullPolicy m_policy;
+    [[no_unique_address]] Stats m_stats;
 };
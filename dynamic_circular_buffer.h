@@ -2,9 +2,19 @@
 #pragma once
 #include <stdexcept>
 #include <initializer_list>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include "iterators.h"
+#include "full_policy.h"
+#include "buffer_stats.h"
 
-template <class T, class Alloc = std::allocator<T>>
+template <class T, class Alloc = std::allocator<T>, class FullPolicy = grow_when_full, class Stats = no_stats>
 class dynamic_circular_buffer {
 public:
     using value_type = T;
@@ -28,7 +38,7 @@ public:
         m_buffer = m_allocator.allocate(m_size);
         m_begin = m_buffer;
         m_end = m_buffer + m_size;
-        m_head = m_begin;
+        m_head = m_tail = m_begin;
 
         pointer it;
         try {
@@ -40,19 +50,19 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, m_size);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     dynamic_circular_buffer(size_t n, const T& val, const Alloc& alloc = Alloc()) {
         if (n == 0)
-            throw std::exception("buffer cannot hold 0 elements of val");
-        
+            throw std::runtime_error("buffer cannot hold 0 elements of val");
+
         m_size = n;
         m_allocator = alloc;
         m_buffer = m_allocator.allocate(m_size);
         m_begin = m_buffer;
         m_end = m_buffer + n;
-        m_head = m_begin;
+        m_head = m_tail = m_begin;
 
         pointer it;
         try {
@@ -63,17 +73,17 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, n);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     dynamic_circular_buffer(const std::initializer_list<T>& list, const Alloc& alloc = Alloc()) {
-        
+
         m_size = list.size();
         m_allocator = alloc;
         m_buffer = m_allocator.allocate(m_size);
         m_begin = m_buffer;
         m_end = m_buffer + m_size;
-        m_head = m_begin;
+        m_head = m_tail = m_begin;
 
         pointer it = m_begin;
         try {
@@ -85,12 +95,12 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, m_size);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
 
-    dynamic_circular_buffer(const Alloc& alloc = Alloc()) : m_allocator(alloc), m_begin(nullptr),
-    m_end(nullptr), m_buffer(nullptr), m_head(nullptr), m_size(0) { }
+    dynamic_circular_buffer(const Alloc& alloc = Alloc()) : m_allocator(alloc), m_size(0), m_buffer(nullptr),
+        m_begin(nullptr), m_end(nullptr), m_head(nullptr), m_tail(nullptr) { }
     dynamic_circular_buffer(size_t n, const Alloc& alloc = Alloc()) {
 
         m_size = n;
@@ -98,7 +108,7 @@ public:
         m_buffer = m_allocator.allocate(m_size);
         m_begin = m_buffer;
         m_end = m_buffer + n;
-        m_head = m_begin;
+        m_head = m_tail = m_begin;
 
         pointer it;
         try {
@@ -109,113 +119,174 @@ public:
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
             m_allocator.deallocate(m_buffer, n);
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     dynamic_circular_buffer(const dynamic_circular_buffer& other)
         : m_allocator(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator))
-        , m_size(other.m_size), m_buffer(m_allocator.allocate(m_size)), m_end(m_buffer + m_size)
-        , m_head(m_begin + (other.m_head - other.m_begin)), m_begin(m_buffer) {
+        , m_size(other.m_size), m_buffer(m_allocator.allocate(other.capacity())), m_begin(m_buffer)
+        , m_end(m_buffer + other.capacity()), m_head(m_begin), m_tail(m_begin), m_growth_factor(other.m_growth_factor) {
         pointer it = m_begin;
         try {
-            for (const_pointer other_it = other.m_begin; other_it != other.m_end; ++other_it, ++it)
-                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(*other_it));
+            for (const_iterator other_it = other.cbegin(); other_it != other.cend(); ++other_it, ++it)
+                std::allocator_traits<Alloc>::construct(m_allocator, it, *other_it);
         }
         catch (...) {
             for (pointer del_it = m_begin; del_it != it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, m_size);
-            throw std::exception("elements consctruction fail");
+            m_allocator.deallocate(m_buffer, capacity());
+            throw std::runtime_error("elements consctruction fail");
         }
+        m_head = (it == m_end) ? m_begin : it;
     }
     dynamic_circular_buffer(dynamic_circular_buffer&& other) noexcept
-        : m_allocator(std::move(other.m_allocator)), m_buffer(other.m_buffer), m_size(other.m_size)
-        , m_begin(other.m_begin), m_end(other.m_end), m_head(other.m_head) {
+        : m_allocator(std::move(other.m_allocator)), m_size(other.m_size), m_buffer(other.m_buffer)
+        , m_begin(other.m_begin), m_end(other.m_end), m_head(other.m_head), m_tail(other.m_tail)
+        , m_growth_factor(other.m_growth_factor) {
         other.m_buffer = nullptr;
         other.m_begin = nullptr;
         other.m_end = nullptr;
         other.m_head = nullptr;
+        other.m_tail = nullptr;
         other.m_size = 0;
     }
     dynamic_circular_buffer& operator =(const dynamic_circular_buffer& other) {
         Alloc new_allocator = std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator);
         if (this != std::addressof(other)) {
-            pointer new_buffer = new_allocator.allocate(other.m_size);
+            const size_t new_capacity = other.capacity();
+            pointer new_buffer = new_capacity == 0 ? nullptr : new_allocator.allocate(new_capacity);
             pointer it = new_buffer;
             try {
-                for (const_pointer other_it = other.m_begin; other_it != other.m_end; ++other_it, ++it)
-                    std::allocator_traits<Alloc>::construct(new_allocator, it, std::move(*other_it));
+                for (const_iterator other_it = other.cbegin(); other_it != other.cend(); ++other_it, ++it)
+                    std::allocator_traits<Alloc>::construct(new_allocator, it, *other_it);
             }
             catch (...) {
                 for (pointer del_it = new_buffer; del_it != it; ++del_it)
                     std::allocator_traits<Alloc>::destroy(new_allocator, del_it);
-                new_allocator.deallocate(new_buffer, other.m_size);
-                throw std::exception("elements consctruction fail");
+                new_allocator.deallocate(new_buffer, new_capacity);
+                throw std::runtime_error("elements consctruction fail");
             }
-            for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, m_size);
+            release();
 
             m_size = other.m_size;
             m_allocator = std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator);
             m_buffer = new_buffer;
             m_begin = new_buffer;
-            m_end = new_buffer + m_size;
-            m_head = m_begin + (other.m_head - other.m_begin);
+            m_end = new_buffer + new_capacity;
+            m_tail = m_begin;
+            m_head = (it == m_end) ? m_begin : it;
+            m_growth_factor = other.m_growth_factor;
         }
         return *this;
     }
     dynamic_circular_buffer& operator =(dynamic_circular_buffer&& other) noexcept {
-        for (pointer it = m_begin; it != m_end; ++it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, it);
-        m_allocator.deallocate(m_buffer, m_size);
+        release();
 
         m_allocator = std::move(other.m_allocator);
+        m_size = other.m_size;
         m_buffer = other.m_buffer;
         m_begin = other.m_begin;
         m_end = other.m_end;
         m_head = other.m_head;
+        m_tail = other.m_tail;
+        m_growth_factor = other.m_growth_factor;
         other.m_buffer = nullptr;
         other.m_begin = nullptr;
         other.m_end = nullptr;
         other.m_head = nullptr;
+        other.m_tail = nullptr;
         other.m_size = 0;
         return *this;
     }
 
     iterator begin() noexcept {
-        return iterator(m_begin, 0, m_size);
+        return iterator(m_begin, m_tail - m_begin, capacity());
     }
     iterator end() noexcept {
-        return iterator(m_begin, m_size, m_size);
+        return iterator(m_begin, (m_tail - m_begin) + m_size, capacity());
+    }
+    const_iterator begin() const noexcept {
+        return cbegin();
+    }
+    const_iterator end() const noexcept {
+        return cend();
     }
     const_iterator cbegin() const noexcept {
-        return const_iterator(m_begin, 0, m_size);
+        return const_iterator(m_begin, m_tail - m_begin, capacity());
     }
     const_iterator cend() const noexcept {
-        return const_iterator(m_begin, m_size, m_size);
+        return const_iterator(m_begin, (m_tail - m_begin) + m_size, capacity());
+    }
+
+    std::span<T> array_one() noexcept {
+        return std::span<T>(std::to_address(m_tail), wrapped() ? m_end - m_tail : m_size);
+    }
+    std::span<T> array_two() noexcept {
+        return std::span<T>(std::to_address(m_begin), wrapped() ? m_head - m_begin : 0);
+    }
+    std::span<const T> array_one() const noexcept {
+        return std::span<const T>(std::to_address(m_tail), wrapped() ? m_end - m_tail : m_size);
+    }
+    std::span<const T> array_two() const noexcept {
+        return std::span<const T>(std::to_address(m_begin), wrapped() ? m_head - m_begin : 0);
+    }
+    std::span<T> linearize() {
+        if (mirrored())
+            return array_one();
+        if (m_size == capacity()) {
+            std::rotate(m_begin, m_tail, m_end);
+        }
+        else if (wrapped()) {
+            // close the free gap first, then everything between m_begin and the last element is constructed
+            move_left(m_tail, m_end, m_head);
+            std::rotate(m_begin, m_head, m_begin + m_size);
+        }
+        else {
+            move_left(m_tail, m_head, m_begin);
+        }
+        m_tail = m_begin;
+        m_head = (m_size == capacity()) ? m_begin : m_begin + m_size;
+        return array_one();
     }
 
     reference operator [](size_t offset) noexcept {
-        return m_buffer[offset];
+        return *slot(offset);
     }
     reference at(size_t offset) {
         if (offset >= m_size)
             throw std::out_of_range("Index of out range");
-        return m_buffer[offset];
+        return *slot(offset);
+    }
+    const_reference operator [](size_t offset) const noexcept {
+        return *slot(offset);
+    }
+    const_reference at(size_t offset) const {
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return *slot(offset);
     }
-    size_t size() const noexcept {
+    size_t size() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
         return m_size;
     }
+    size_t capacity() const noexcept {
+        return m_end - m_begin;
+    }
     size_t max_size() const noexcept {
         return std::numeric_limits<difference_type>::max();
     }
 
     reference front() noexcept {
-        return m_buffer[0];
+        return *m_tail;
     }
     reference back() noexcept {
-        return m_buffer[m_size - 1];
+        return *slot(m_size - 1);
+    }
+    const_reference front() const noexcept {
+        return *m_tail;
+    }
+    const_reference back() const noexcept {
+        return *slot(m_size - 1);
     }
 
     template <typename Iter>
@@ -239,7 +310,7 @@ public:
         catch (...) {
             std::allocator_traits<Alloc>::destroy(m_allocator, std::addressof(*it));
             std::allocator_traits<Alloc>::construct(m_allocator, std::addressof(*it), std::forward<T>(temp));
-            throw std::exception("elements consctruction fail");
+            throw std::runtime_error("elements consctruction fail");
         }
     }
     void insert(iterator it, size_t n, T&& val) {
@@ -253,65 +324,128 @@ public:
                 it = this->begin();
         }
     }
-    
+
+    // returns false if FullPolicy rejected the element
     template <typename... Args>
-    void emplace_back(Args&&... args) {
-        T temp = std::move(*m_head);
-        try {
-            std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
-            std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::forward<Args>(args)...);
-        }
-        catch (...) {
-            std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
-            std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::move(temp));
-            throw std::exception("elements consctruction fail");
+    bool emplace_back(Args&&... args) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == capacity()) {
+            if constexpr (std::is_same_v<FullPolicy, reject_newest>) {
+                m_stats.dropped(1);
+                return false;
+            }
+            else if constexpr (std::is_same_v<FullPolicy, block_when_full>) {
+                // nothing frees a slot in a buffer without any
+                if (capacity() == 0)
+                    throw std::length_error("buffer has no capacity");
+                m_policy.wait(lock, [this] { return m_size != capacity(); });
+            }
+            else if constexpr (std::is_same_v<FullPolicy, overwrite_oldest>) {
+                if (m_size == 0) {
+                    m_stats.dropped(1);
+                    return false;
+                }
+                // built before touching the oldest slot, so args may refer to it
+                *m_head = T(std::forward<Args>(args)...);
+                m_tail = next(m_tail);
+                m_head = next(m_head);
+                m_stats.overwritten(1);
+                m_stats.pushed(1, m_size);
+                return true;
+            }
+            else {
+                // built before reallocating, so args may refer to an element of the buffer
+                T val(std::forward<Args>(args)...);
+                grow(m_size + 1);
+                std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::move(val));
+                ++m_size;
+                m_head = next(m_head);
+                m_stats.pushed(1, m_size);
+                return true;
+            }
         }
-        ++m_head;
-        if (m_head == m_end)
-            m_head = m_begin;
+        std::allocator_traits<Alloc>::construct(m_allocator, m_head, std::forward<Args>(args)...);
+        ++m_size;
+        m_head = next(m_head);
+        m_stats.pushed(1, m_size);
+        return true;
     }
-    void push_back(T&& val) {
-        emplace_back(std::move(val));
+    bool push_back(T&& val) {
+        return emplace_back(std::move(val));
+    }
+    bool push_back(const T& val) {
+        return emplace_back(val);
+    }
+    // returns how many of the elements are in the buffer afterwards
+    template <typename Iter>
+    size_t push_back(Iter first, Iter last) {
+        // write() hands block_when_full back here, it takes the element loop below
+        if constexpr (std::contiguous_iterator<Iter> && std::is_same_v<std::iter_value_t<Iter>, T> && !std::is_same_v<FullPolicy, block_when_full>) {
+            return write(std::to_address(first), last - first);
+        }
+        else if constexpr (std::forward_iterator<Iter> && !std::is_same_v<FullPolicy, block_when_full>) {
+            size_t n = std::distance(first, last);
+            std::advance(first, make_room(n));
+            store(first, n);
+            return n;
+        }
+        else {
+            size_t count = 0;
+            for (; first != last && emplace_back(*first); ++first)
+                ++count;
+            return count;
+        }
     }
-    void push_back(const T& val) {
-        emplace_back(val);
+    size_t write(const T* data, size_t n) {
+        if constexpr (std::is_same_v<FullPolicy, block_when_full>) {
+            return push_back(data, data + n);
+        }
+        else {
+            data += make_room(n);
+            store(data, n);
+            return n;
+        }
     }
 
     void pop_back() {
-        this->erase(this->end() - 1);
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        m_head = (m_head == m_begin ? m_end : m_head) - 1;
+        std::allocator_traits<Alloc>::destroy(m_allocator, m_head);
+        --m_size;
+        m_stats.popped(1);
+        m_policy.notify();
     }
     void pop_front() {
-        this->erase(this->begin());
+        [[maybe_unused]] auto lock = m_policy.lock();
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        std::allocator_traits<Alloc>::destroy(m_allocator, m_tail);
+        m_tail = next(m_tail);
+        --m_size;
+        m_stats.popped(1);
+        m_policy.notify();
     }
     void erase(iterator erase_it) {
         if (erase_it == this->end())
             throw std::out_of_range("Invalid iterator");
         if (m_size == 0)
             return;
-        size_t new_size = m_size - 1;
-        pointer new_m_buffer = m_allocator.allocate(new_size);
-        pointer other_it = new_m_buffer;
-        try {
-            for (pointer it = m_begin; it != m_end; ++it) {
-                if(it != std::addressof(*erase_it))
-                    std::allocator_traits<Alloc>::construct(m_allocator, other_it++, std::move(*it));
-            }
+        // like std::deque, only the shorter side of the erased element is shifted
+        const size_t index = erase_it - this->begin();
+        if (index < m_size / 2) {
+            for (iterator it = erase_it; it != this->begin(); --it)
+                *it = std::move(*(iterator(it) -= 1));
+            this->pop_front();
         }
-        catch (...) {
-            for (pointer del_it = new_m_buffer; del_it != other_it; ++del_it)
-                std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(new_m_buffer, new_size);
-            throw std::exception("elements consctruction fail");
+        else {
+            for (iterator it = erase_it, next_it = erase_it; ++next_it != this->end(); ++it)
+                *it = std::move(*next_it);
+            this->pop_back();
         }
-        for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-        m_allocator.deallocate(m_buffer, m_size);
-        m_buffer = new_m_buffer;
-        m_size = new_size;
-        m_head = m_begin = m_buffer;
-        m_end = m_buffer + new_size;
     }
-    
+
     void swap(dynamic_circular_buffer& other) noexcept {
         if (this == std::addressof(other))
             return;
@@ -320,83 +454,205 @@ public:
         std::swap(this->m_end, other.m_end);
         std::swap(this->m_buffer, other.m_buffer);
         std::swap(this->m_head, other.m_head);
+        std::swap(this->m_tail, other.m_tail);
         std::swap(this->m_size, other.m_size);
+        std::swap(this->m_growth_factor, other.m_growth_factor);
+        m_stats.swap(other.m_stats);
     }
-    void clear() {
-        for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-        m_allocator.deallocate(m_buffer, m_size);
-        m_head = m_begin = m_end = m_buffer = nullptr;
+    void clear() noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
+        destroy_elements();
+        m_head = m_tail = m_begin;
         m_size = 0;
+        m_policy.notify();
     }
-    bool empty() const noexcept {
+    bool empty() const noexcept(nothrow_lock) {
+        [[maybe_unused]] auto lock = m_policy.lock();
         return ((m_size == 0) ? true : false);
     }
+
+    buffer_stats_snapshot stats() const noexcept {
+        return m_stats.snapshot();
+    }
+    void reset_stats() noexcept {
+        m_stats.reset();
+    }
     void resize(size_t new_size) {
-        if (new_size == m_size)
+        while (m_size > new_size)
+            this->pop_back();
+        if (new_size > capacity())
+            reallocate(new_size);
+        while (m_size < new_size)
+            this->emplace_back();
+    }
+    void reserve(size_t new_capacity) {
+        if (new_capacity > capacity())
+            reallocate(new_capacity);
+    }
+    void shrink_to_fit() {
+        if (m_size == capacity())
+            return;
+        if (m_size == 0) {
+            release();
+            m_head = m_tail = m_begin = m_end = m_buffer = nullptr;
             return;
-        if (new_size < m_size) {
-            if (new_size == 0)
-                this->clear();
-            else {
-                pointer new_m_buffer = m_allocator.allocate(new_size);
-                pointer other_it = new_m_buffer;
-                try {
-                    for (pointer it = m_begin; other_it != new_m_buffer + new_size; ++it, ++other_it)
-                        std::allocator_traits<Alloc>::construct(m_allocator, other_it, std::move(*it));
-                }
-                catch (...) {
-                    for (pointer del_it = new_m_buffer; del_it != other_it; ++del_it)
-                        std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-                    m_allocator.deallocate(new_m_buffer, new_size);
-                    throw std::exception("elements consctruction fail");
-                }
-                for (pointer del_it = m_begin; del_it != m_end; ++del_it)
-                    std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-                m_allocator.deallocate(m_buffer, m_size);
-                m_buffer = new_m_buffer;
-                m_size = new_size;
-                m_head = m_begin = m_buffer;
-                m_end = m_buffer + new_size;
-            }
         }
-        else {
-            pointer new_m_buffer = m_allocator.allocate(new_size);
-            pointer other_it = new_m_buffer;
-            try {
-                for (pointer it = m_begin; it != m_end; ++it, ++other_it)
-                    std::allocator_traits<Alloc>::construct(m_allocator, other_it, std::move(*it));
-                for (; other_it != new_m_buffer + new_size; ++other_it)
-                    std::allocator_traits<Alloc>::construct(m_allocator, other_it, std::move(T()));
+        reallocate(m_size);
+    }
+
+    double growth_factor() const noexcept {
+        return m_growth_factor;
+    }
+    void set_growth_factor(double factor) {
+        if (!(factor > 1.0))
+            throw std::invalid_argument("growth factor must be greater than 1");
+        m_growth_factor = factor;
+    }
+
+    ~dynamic_circular_buffer() noexcept {
+        release();
+    }
+private:
+    // block_when_full's lock can throw std::system_error, the members that take it are only noexcept without it
+    static constexpr bool nothrow_lock = noexcept(std::declval<FullPolicy&>().lock());
+
+    pointer next(pointer it) const noexcept {
+        return (++it == m_end) ? m_begin : it;
+    }
+    pointer slot(size_t offset) const noexcept {
+        const size_t index = (m_tail - m_begin) + offset;
+        return m_begin + (index < capacity() ? index : index - capacity());
+    }
+    // storage that is mapped twice in a row never wraps as far as the spans are concerned
+    bool wrapped() const noexcept {
+        return m_size != 0 && m_head <= m_tail && !mirrored();
+    }
+    bool mirrored() const noexcept {
+        if constexpr (requires(const Alloc& a) { a.is_mirrored(m_buffer, capacity()); })
+            return m_buffer != nullptr && m_allocator.is_mirrored(m_buffer, capacity());
+        else
+            return false;
+    }
+    void destroy_elements() noexcept {
+        pointer it = m_tail;
+        for (size_t i = 0; i != m_size; ++i, it = next(it))
+            std::allocator_traits<Alloc>::destroy(m_allocator, it);
+    }
+    void release() noexcept {
+        if (m_buffer == nullptr)
+            return;
+        destroy_elements();
+        m_allocator.deallocate(m_buffer, capacity());
+    }
+
+    // frees slots for n new elements as FullPolicy allows and trims n to the ones that get stored,
+    // returns how many leading elements are skipped
+    size_t make_room(size_t& n) {
+        if constexpr (std::is_same_v<FullPolicy, reject_newest>) {
+            m_stats.dropped(n - std::min(n, capacity() - m_size));
+            n = std::min(n, capacity() - m_size);
+        }
+        else if constexpr (std::is_same_v<FullPolicy, overwrite_oldest>) {
+            if (n >= capacity()) {
+                const size_t skip = n - capacity();
+                m_stats.pushed(skip, m_size);
+                m_stats.overwritten(m_size + skip);
+                this->clear();
+                n = capacity();
+                return skip;
             }
-            catch (...) {
-                for (pointer del_it = new_m_buffer; del_it != other_it; ++del_it)
-                    std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-                throw std::exception("elements consctruction fail");
-                m_allocator.deallocate(new_m_buffer, new_size);
+            if (m_size + n > capacity())
+                m_stats.overwritten(m_size + n - capacity());
+            for (; m_size + n > capacity(); --m_size) {
+                std::allocator_traits<Alloc>::destroy(m_allocator, m_tail);
+                m_tail = next(m_tail);
             }
-            for (pointer del_it = m_begin; del_it != m_end; ++del_it)
+        }
+        else if (m_size + n > capacity()) {
+            grow(m_size + n);
+        }
+        return 0;
+    }
+    void grow(size_t min_capacity) {
+        const size_t scaled = static_cast<size_t>(capacity() * m_growth_factor);
+        reallocate(std::max({ min_capacity, scaled, capacity() + 1 }));
+    }
+    // moves the first min(size, new_capacity) elements into new storage starting at its first slot, mirrored storage is rounded up to whole pages
+    void reallocate(size_t new_capacity) {
+        if constexpr (requires { Alloc::mirrored_capacity(new_capacity); })
+            new_capacity = Alloc::mirrored_capacity(new_capacity);
+        const size_t new_size = std::min(m_size, new_capacity);
+        pointer new_m_buffer = m_allocator.allocate(new_capacity);
+        pointer other_it = new_m_buffer;
+        try {
+            for (iterator it = this->begin(); other_it != new_m_buffer + new_size; ++it, ++other_it)
+                std::allocator_traits<Alloc>::construct(m_allocator, other_it, std::move_if_noexcept(*it));
+        }
+        catch (...) {
+            for (pointer del_it = new_m_buffer; del_it != other_it; ++del_it)
                 std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
-            m_allocator.deallocate(m_buffer, m_size);
-            m_buffer = new_m_buffer;
-            m_size = new_size;
-            m_head = m_begin = m_buffer;
-            m_end = m_buffer + new_size;
+            m_allocator.deallocate(new_m_buffer, new_capacity);
+            throw std::runtime_error("elements consctruction fail");
         }
+        release();
+        m_buffer = m_begin = m_tail = new_m_buffer;
+        m_end = new_m_buffer + new_capacity;
+        m_size = new_size;
+        m_head = (new_size == new_capacity) ? m_begin : m_begin + new_size;
+        m_stats.reallocated(new_size * sizeof(T));
     }
 
-    ~dynamic_circular_buffer() noexcept {
-        if (m_buffer == nullptr)
+    // moves [first, last) down to dest, where [dest, first) holds no elements
+    void move_left(pointer first, pointer last, pointer dest) {
+        if (dest == first)
             return;
-        for (pointer it = m_begin; it != m_end; ++it)
-            std::allocator_traits<Alloc>::destroy(m_allocator, it);
-        m_allocator.deallocate(m_buffer, m_size);
+        pointer it = dest;
+        for (pointer src = first; src != last; ++src, ++it) {
+            if (it < first)
+                std::allocator_traits<Alloc>::construct(m_allocator, it, std::move(*src));
+            else
+                *it = std::move(*src);
+        }
+        for (pointer del_it = std::max(it, first); del_it != last; ++del_it)
+            std::allocator_traits<Alloc>::destroy(m_allocator, del_it);
     }
-private:
+
+    // stores n elements at m_head, there must be at least n free slots
+    template <typename Iter>
+    void store(Iter first, size_t n) {
+        if constexpr (std::is_trivially_copyable_v<T> && std::is_same_v<Iter, const T*>) {
+            // branching on the split, rather than clamping it, lets GCC see both sizes are in range
+            const size_t room = m_end - m_head;
+            if (n <= room) {
+                if (n != 0)
+                    std::memcpy(std::to_address(m_head), first, n * sizeof(T));
+            }
+            else {
+                std::memcpy(std::to_address(m_head), first, room * sizeof(T));
+                std::memcpy(std::to_address(m_begin), first + room, (n - room) * sizeof(T));
+            }
+            const size_t head = (m_head - m_begin) + n;
+            m_head = m_begin + (head < capacity() ? head : head - capacity());
+            m_size += n;
+        }
+        else {
+            for (size_t i = 0; i != n; ++i, ++first) {
+                std::allocator_traits<Alloc>::construct(m_allocator, m_head, *first);
+                m_head = next(m_head);
+                ++m_size;
+            }
+        }
+        m_stats.pushed(n, m_size);
+    }
+
     Alloc m_allocator;
     size_t m_size;
     pointer m_buffer;
     pointer m_begin;
     pointer m_end;
     pointer m_head;
+    pointer m_tail;
+    double m_growth_factor = 2.0;
+    [[no_unique_address]] mutable FullPolicy m_policy;
+    [[no_unique_address]] Stats m_stats;
 };
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+
+// What push_back does when every slot is taken. The buffers pick the branch at compile time,
+// lock() and notify() are the hooks their push and pop operations call.
+
+struct unsynchronized_policy {
+    struct no_lock {};
+
+    no_lock lock() noexcept {
+        return {};
+    }
+    void notify() noexcept {}
+};
+
+// the newest element replaces the oldest one
+struct overwrite_oldest : unsynchronized_policy {};
+// the element is not stored and push_back returns false
+struct reject_newest : unsynchronized_policy {};
+// the storage is reallocated, only for buffers with a runtime capacity
+struct grow_when_full : unsynchronized_policy {};
+
+// push_back waits until another thread pops. Push, pop, clear and the size queries take the lock,
+// everything else still needs external synchronization.
+class block_when_full {
+public:
+    block_when_full() = default;
+    // a copied buffer gets its own lock
+    block_when_full(const block_when_full&) noexcept {}
+    block_when_full& operator =(const block_when_full&) noexcept {
+        return *this;
+    }
+
+    std::unique_lock<std::mutex> lock() {
+        return std::unique_lock<std::mutex>(m_mutex);
+    }
+    template <class Pred>
+    void wait(std::unique_lock<std::mutex>& lock, Pred has_room) {
+        m_not_full.wait(lock, has_room);
+    }
+    void notify() noexcept {
+        m_not_full.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_full;
+};
@@ -0,0 +1,253 @@
+#pragma once
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "circular_buffer.h"
+
+// Passed as the allocator to keep the N slots inside the circular_buffer object itself.
+struct inline_storage {};
+
+// circular_buffer without a heap allocation. The slots are a union member, so elements are
+// still constructed only when pushed, and everything is constexpr: small rings can be built
+// and read at compile time. It is opt-in and has a smaller API than the heap buffer: always
+// overwrite_oldest without stats, and no write(), linearize(), stats() or sequence numbers.
+template <class T, size_t N>
+class circular_buffer<T, N, inline_storage, overwrite_oldest, no_stats> {
+public:
+    static_assert(N > 0, "N must be greater than 0");
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using iterator = circ_buff_iter<T, N>;
+    using const_iterator = circ_buff_const_iter<T, N>;
+
+    constexpr circular_buffer() noexcept {
+        start_lifetimes();
+    }
+    constexpr circular_buffer(const T& val) {
+        start_lifetimes();
+        for (size_t i = 0; i != N; ++i)
+            emplace_back(val);
+    }
+    constexpr circular_buffer(const std::initializer_list<T>& list) {
+        if (list.size() > N)
+            throw std::range_error("initializer list length is greater then size of bufffer");
+        start_lifetimes();
+        for (const T& val : list)
+            emplace_back(val);
+    }
+    template <typename Iter>
+    constexpr circular_buffer(Iter first, Iter last) {
+        if (std::distance(first, last) > static_cast<difference_type>(N) || std::distance(first, last) < 0)
+            throw std::range_error("incorrect iterators");
+        start_lifetimes();
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+    constexpr circular_buffer(const circular_buffer& other) {
+        start_lifetimes();
+        for (const T& val : other)
+            emplace_back(val);
+    }
+    constexpr circular_buffer(circular_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        start_lifetimes();
+        for (T& val : other)
+            emplace_back(std::move(val));
+        other.clear();
+    }
+    constexpr circular_buffer& operator =(const circular_buffer& other) {
+        if (this != std::addressof(other)) {
+            clear();
+            for (const T& val : other)
+                emplace_back(val);
+        }
+        return *this;
+    }
+    constexpr circular_buffer& operator =(circular_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != std::addressof(other)) {
+            clear();
+            for (T& val : other)
+                emplace_back(std::move(val));
+            other.clear();
+        }
+        return *this;
+    }
+    constexpr ~circular_buffer() {
+        clear();
+    }
+
+    constexpr iterator begin() noexcept {
+        return iterator(m_data, m_tail, N);
+    }
+    constexpr iterator end() noexcept {
+        return iterator(m_data, m_tail + m_size, N);
+    }
+    constexpr const_iterator begin() const noexcept {
+        return const_iterator(m_data, m_tail, N);
+    }
+    constexpr const_iterator end() const noexcept {
+        return const_iterator(m_data, m_tail + m_size, N);
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr std::span<T> array_one() noexcept {
+        return std::span<T>(m_data + m_tail, first_part());
+    }
+    constexpr std::span<T> array_two() noexcept {
+        return std::span<T>(m_data, m_size - first_part());
+    }
+    constexpr std::span<const T> array_one() const noexcept {
+        return std::span<const T>(m_data + m_tail, first_part());
+    }
+    constexpr std::span<const T> array_two() const noexcept {
+        return std::span<const T>(m_data, m_size - first_part());
+    }
+
+    constexpr reference operator [](size_t offset) noexcept {
+        return m_data[slot(offset)];
+    }
+    constexpr const_reference operator [](size_t offset) const noexcept {
+        return m_data[slot(offset)];
+    }
+    constexpr reference at(size_t offset) {
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return m_data[slot(offset)];
+    }
+    constexpr const_reference at(size_t offset) const {
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return m_data[slot(offset)];
+    }
+    constexpr reference front() noexcept {
+        return m_data[m_tail];
+    }
+    constexpr const_reference front() const noexcept {
+        return m_data[m_tail];
+    }
+    constexpr reference back() noexcept {
+        return m_data[slot(m_size - 1)];
+    }
+    constexpr const_reference back() const noexcept {
+        return m_data[slot(m_size - 1)];
+    }
+
+    constexpr size_t size() const noexcept {
+        return m_size;
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    constexpr size_t max_size() const noexcept {
+        return N;
+    }
+    constexpr bool empty() const noexcept {
+        return m_size == 0;
+    }
+    constexpr bool full() const noexcept {
+        return m_size == N;
+    }
+
+    template <typename... Args>
+    constexpr bool emplace_back(Args&&... args) {
+        if (m_size == N) {
+            // built before touching the oldest slot, so args may refer to it
+            m_data[m_tail] = T(std::forward<Args>(args)...);
+            m_tail = next(m_tail);
+        }
+        else {
+            std::construct_at(m_data + slot(m_size), std::forward<Args>(args)...);
+            ++m_size;
+        }
+        return true;
+    }
+    constexpr bool push_back(T&& val) {
+        return emplace_back(std::move(val));
+    }
+    constexpr bool push_back(const T& val) {
+        return emplace_back(val);
+    }
+    template <typename Iter>
+    constexpr size_t push_back(Iter first, Iter last) {
+        size_t count = 0;
+        for (; first != last; ++first, ++count)
+            emplace_back(*first);
+        return std::min(count, N);
+    }
+
+    constexpr void pop_front() {
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        std::destroy_at(m_data + m_tail);
+        m_tail = next(m_tail);
+        --m_size;
+    }
+    constexpr void pop_back() {
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        std::destroy_at(m_data + slot(m_size - 1));
+        --m_size;
+    }
+    constexpr void clear() noexcept {
+        for (; m_size != 0; --m_size, m_tail = next(m_tail))
+            std::destroy_at(m_data + m_tail);
+        m_tail = 0;
+    }
+    constexpr void swap(circular_buffer& other) {
+        circular_buffer temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+private:
+    // trivial slots are value-initialized during constant evaluation, where no object may be left uninitialized
+    constexpr void start_lifetimes() noexcept {
+        if constexpr (std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>) {
+            if (std::is_constant_evaluated()) {
+                for (size_t i = 0; i != N; ++i)
+                    std::construct_at(m_data + i);
+            }
+        }
+    }
+    constexpr size_t next(size_t index) const noexcept {
+        return index + 1 == N ? 0 : index + 1;
+    }
+    constexpr size_t slot(size_t offset) const noexcept {
+        const size_t index = m_tail + offset;
+        return index < N ? index : index - N;
+    }
+    constexpr size_t first_part() const noexcept {
+        return std::min(m_size, N - m_tail);
+    }
+
+    union {
+        T m_data[N];
+    };
+    size_t m_tail = 0;
+    size_t m_size = 0;
+};
+
+template <class T, size_t N, class FullPolicy, class Stats>
+class circular_buffer<T, N, inline_storage, FullPolicy, Stats> {
+    static_assert(std::is_same_v<FullPolicy, overwrite_oldest> && std::is_same_v<Stats, no_stats>,
+        "inline storage supports only overwrite_oldest without stats");
+};
+
+template <class T, size_t N>
+using inline_circular_buffer = circular_buffer<T, N, inline_storage>;
@@ -1,6 +1,12 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <utility>
 
-template<typename T>
+template<typename T, size_t Capacity = 0>
 class circ_buff_const_iter {
 public:
     using value_type = T;
@@ -9,86 +15,134 @@ public:
     using difference_type = std::ptrdiff_t;
     using iterator_category = std::random_access_iterator_tag;
 
-    circ_buff_const_iter(pointer buffer, size_t index, size_t capacity)
-        : m_buffer(buffer), m_index(index), m_capacity(capacity) {}
-    circ_buff_const_iter(const circ_buff_const_iter& other)
-        : m_buffer(other.m_buffer), m_index(other.m_index), m_capacity(other.m_capacity) {}
+    constexpr circ_buff_const_iter(pointer buffer, size_t index, size_t capacity)
+        : m_buffer(buffer), m_ptr(buffer + wrap(index, capacity)), m_index(index), m_capacity(capacity) {}
+    constexpr circ_buff_const_iter() noexcept = default;
 
-    reference operator*() {
-        return m_buffer[m_index % m_capacity];
+    constexpr reference operator*() const {
+        return *m_ptr;
     }
-    pointer operator->() {
-        return &m_buffer[m_index % m_capacity];
+    constexpr pointer operator->() const {
+        return m_ptr;
+    }
+    constexpr reference operator[](const difference_type n) const {
+        return *(*this + n);
     }
 
-    circ_buff_const_iter& operator++() {
+    constexpr circ_buff_const_iter& operator++() {
         ++m_index;
+        if constexpr (masked)
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        else if (++m_ptr == m_buffer + m_capacity)
+            m_ptr = m_buffer;
         return *this;
     }
-    circ_buff_const_iter operator++(int) {
+    constexpr circ_buff_const_iter operator++(int) {
         circ_buff_const_iter temp(*this);
         ++(*this);
         return temp;
     }
 
-    circ_buff_const_iter& operator--() {
+    constexpr circ_buff_const_iter& operator--() {
         --m_index;
+        if constexpr (masked)
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        else {
+            if (m_ptr == m_buffer)
+                m_ptr = m_buffer + m_capacity;
+            --m_ptr;
+        }
         return *this;
     }
-    circ_buff_const_iter operator--(int) {
+    constexpr circ_buff_const_iter operator--(int) {
         circ_buff_const_iter temp(*this);
         --(*this);
         return temp;
     }
 
-    circ_buff_const_iter& operator+(const difference_type n) const {
-        return circ_buff_const_iter(*this) += n;
+    constexpr circ_buff_const_iter operator+(const difference_type n) const {
+        circ_buff_const_iter temp(*this);
+        return temp += n;
     }
-    circ_buff_const_iter& operator-(const difference_type n) const {
-        return circ_buff_const_iter(*this) -= n;
+    constexpr circ_buff_const_iter operator-(const difference_type n) const {
+        circ_buff_const_iter temp(*this);
+        return temp -= n;
+    }
+    friend constexpr circ_buff_const_iter operator+(const difference_type n, const circ_buff_const_iter& it) {
+        return it + n;
     }
 
-    circ_buff_const_iter& operator+=(const difference_type n) {
+    constexpr circ_buff_const_iter& operator+=(const difference_type n) {
         m_index += n;
+        if constexpr (masked) {
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        }
+        else {
+            const difference_type offset = (m_ptr - m_buffer) + n;
+            if (offset >= static_cast<difference_type>(m_capacity))
+                m_ptr = m_buffer + (offset - m_capacity);
+            else if (offset < 0)
+                m_ptr = m_buffer + (offset + m_capacity);
+            else
+                m_ptr = m_buffer + offset;
+        }
         return *this;
     }
-    circ_buff_const_iter& operator-=(const difference_type n) {
-        m_index -= n;
-        return *this;
+    constexpr circ_buff_const_iter& operator-=(const difference_type n) {
+        return *this += -n;
     }
 
-    difference_type operator-(const circ_buff_const_iter& other) const {
+    constexpr difference_type operator-(const circ_buff_const_iter& other) const {
         return m_index - other.m_index;
     }
 
-    bool operator==(const circ_buff_const_iter& other) const {
+    constexpr bool operator==(const circ_buff_const_iter& other) const {
         return m_index == other.m_index;
     }
-    bool operator!=(const circ_buff_const_iter& other) const {
+    constexpr bool operator!=(const circ_buff_const_iter& other) const {
         return !(*this == other);
     }
 
-    bool operator<(const circ_buff_const_iter& other) const {
+    constexpr bool operator<(const circ_buff_const_iter& other) const {
         return m_index < other.m_index;
     }
-    bool operator>(const circ_buff_const_iter& other) const {
+    constexpr bool operator>(const circ_buff_const_iter& other) const {
         return m_index > other.m_index;
     }
 
-    bool operator<=(const circ_buff_const_iter& other) const {
+    constexpr bool operator<=(const circ_buff_const_iter& other) const {
         return m_index <= other.m_index;
     }
-    bool operator>=(const circ_buff_const_iter& other) const {
+    constexpr bool operator>=(const circ_buff_const_iter& other) const {
         return m_index >= other.m_index;
     }
 
+    // [*this, last) as at most two contiguous pieces of the storage, in order
+    constexpr std::pair<std::span<const T>, std::span<const T>> segments(const circ_buff_const_iter& last) const noexcept {
+        const size_t count = last.m_index - m_index;
+        assert(count <= m_capacity);
+        const size_t first = std::min(count, static_cast<size_t>(m_buffer + m_capacity - m_ptr));
+        return { std::span<const T>(m_ptr, first), std::span<const T>(m_buffer, count - first) };
+    }
+
 private:
-    pointer m_buffer;
-    size_t m_index;
-    size_t m_capacity;
+    static constexpr bool masked = Capacity != 0 && (Capacity & (Capacity - 1)) == 0;
+
+    // positions stay below 2 * capacity, so a single compare replaces the division
+    static constexpr size_t wrap(size_t index, size_t capacity) noexcept {
+        if constexpr (masked)
+            return index & (Capacity - 1);
+        else
+            return index < capacity ? index : index - capacity;
+    }
+
+    pointer m_buffer = nullptr;
+    pointer m_ptr = nullptr;
+    size_t m_index = 0;
+    size_t m_capacity = 0;
 };
 
-template<typename T>
+template<typename T, size_t Capacity = 0>
 class circ_buff_iter {
 public:
     using value_type = T;
@@ -97,85 +151,133 @@ public:
     using difference_type = std::ptrdiff_t;
     using iterator_category = std::random_access_iterator_tag;
 
-    circ_buff_iter(pointer buffer, size_t index, size_t capacity)
-        : m_buffer(buffer), m_index(index), m_capacity(capacity) {}
-    circ_buff_iter(const circ_buff_iter& other)
-        : m_buffer(other.m_buffer), m_index(other.m_index), m_capacity(other.m_capacity) {}
+    constexpr circ_buff_iter(pointer buffer, size_t index, size_t capacity)
+        : m_buffer(buffer), m_ptr(buffer + wrap(index, capacity)), m_index(index), m_capacity(capacity) {}
+    constexpr circ_buff_iter() noexcept = default;
 
-    reference operator* () {
-        return m_buffer[m_index % m_capacity];
+    constexpr reference operator*() const {
+        return *m_ptr;
     }
-    pointer operator->() {
-        return &m_buffer[m_index % m_capacity];
+    constexpr pointer operator->() const {
+        return m_ptr;
+    }
+    constexpr reference operator[](const difference_type n) const {
+        return *(*this + n);
     }
 
-    circ_buff_iter& operator++() {
+    constexpr circ_buff_iter& operator++() {
         ++m_index;
+        if constexpr (masked)
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        else if (++m_ptr == m_buffer + m_capacity)
+            m_ptr = m_buffer;
         return *this;
     }
-    circ_buff_iter operator++(int) {
+    constexpr circ_buff_iter operator++(int) {
         circ_buff_iter temp(*this);
         ++(*this);
         return temp;
     }
 
-    circ_buff_iter& operator--() {
+    constexpr circ_buff_iter& operator--() {
         --m_index;
+        if constexpr (masked)
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        else {
+            if (m_ptr == m_buffer)
+                m_ptr = m_buffer + m_capacity;
+            --m_ptr;
+        }
         return *this;
     }
-    circ_buff_iter operator--(int) {
+    constexpr circ_buff_iter operator--(int) {
         circ_buff_iter temp(*this);
         --(*this);
         return temp;
     }
 
-    circ_buff_iter& operator+(const difference_type n) const {
-        return circ_buff_iter(*this) += n;
+    constexpr circ_buff_iter operator+(const difference_type n) const {
+        circ_buff_iter temp(*this);
+        return temp += n;
     }
-    circ_buff_iter& operator-(const difference_type n) const {
-        return circ_buff_iter(*this) -= n;
+    constexpr circ_buff_iter operator-(const difference_type n) const {
+        circ_buff_iter temp(*this);
+        return temp -= n;
+    }
+    friend constexpr circ_buff_iter operator+(const difference_type n, const circ_buff_iter& it) {
+        return it + n;
     }
 
-    circ_buff_iter& operator+=(const difference_type n) {
+    constexpr circ_buff_iter& operator+=(const difference_type n) {
         m_index += n;
+        if constexpr (masked) {
+            m_ptr = m_buffer + (m_index & (Capacity - 1));
+        }
+        else {
+            const difference_type offset = (m_ptr - m_buffer) + n;
+            if (offset >= static_cast<difference_type>(m_capacity))
+                m_ptr = m_buffer + (offset - m_capacity);
+            else if (offset < 0)
+                m_ptr = m_buffer + (offset + m_capacity);
+            else
+                m_ptr = m_buffer + offset;
+        }
         return *this;
     }
-    circ_buff_iter& operator-=(const difference_type n) {
-        m_index -= n;
-        return *this;
+    constexpr circ_buff_iter& operator-=(const difference_type n) {
+        return *this += -n;
     }
 
-    difference_type operator-(const circ_buff_iter& other) const {
+    constexpr difference_type operator-(const circ_buff_iter& other) const {
         return m_index - other.m_index;
     }
 
-    bool operator==(const circ_buff_iter& other) const {
+    constexpr bool operator==(const circ_buff_iter& other) const {
         return m_index == other.m_index;
     }
-    bool operator!=(const circ_buff_iter& other) const {
+    constexpr bool operator!=(const circ_buff_iter& other) const {
         return !(*this == other);
     }
 
-    bool operator<(const circ_buff_iter& other) const {
+    constexpr bool operator<(const circ_buff_iter& other) const {
         return m_index < other.m_index;
     }
-    bool operator>(const circ_buff_iter& other) const {
+    constexpr bool operator>(const circ_buff_iter& other) const {
         return m_index > other.m_index;
     }
 
-    bool operator<=(const circ_buff_iter& other) const {
+    constexpr bool operator<=(const circ_buff_iter& other) const {
         return m_index <= other.m_index;
     }
-    bool operator>=(const circ_buff_iter& other) const {
+    constexpr bool operator>=(const circ_buff_iter& other) const {
         return m_index >= other.m_index;
     }
 
-    operator circ_buff_const_iter<T>() const {
-        return circ_buff_const_iter<T>(m_buffer, m_index, m_capacity);
+    constexpr operator circ_buff_const_iter<T, Capacity>() const {
+        return circ_buff_const_iter<T, Capacity>(m_buffer, m_index, m_capacity);
+    }
+
+    // [*this, last) as at most two contiguous pieces of the storage, in order
+    constexpr std::pair<std::span<T>, std::span<T>> segments(const circ_buff_iter& last) const noexcept {
+        const size_t count = last.m_index - m_index;
+        assert(count <= m_capacity);
+        const size_t first = std::min(count, static_cast<size_t>(m_buffer + m_capacity - m_ptr));
+        return { std::span<T>(m_ptr, first), std::span<T>(m_buffer, count - first) };
     }
 
 private:
-    pointer m_buffer;
-    size_t m_index;
-    size_t m_capacity;
+    static constexpr bool masked = Capacity != 0 && (Capacity & (Capacity - 1)) == 0;
+
+    // positions stay below 2 * capacity, so a single compare replaces the division
+    static constexpr size_t wrap(size_t index, size_t capacity) noexcept {
+        if constexpr (masked)
+            return index & (Capacity - 1);
+        else
+            return index < capacity ? index : index - capacity;
+    }
+
+    pointer m_buffer = nullptr;
+    pointer m_ptr = nullptr;
+    size_t m_index = 0;
+    size_t m_capacity = 0;
 };
\ No newline at end of file
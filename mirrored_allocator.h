@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Maps the storage twice, back to back, so element i + capacity aliases element i and any
+// window of up to capacity elements is contiguous. Falls back to ordinary memory if the
+// double mapping cannot be made.
+template <class T>
+class mirrored_allocator {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "mirrored storage aliases elements, T must be trivially copyable");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    mirrored_allocator() noexcept = default;
+    template <class U>
+    mirrored_allocator(const mirrored_allocator<U>&) noexcept {}
+
+#if defined(__linux__)
+    T* allocate(size_t n) {
+        const size_t page = page_size();
+        const size_t bytes = mapping_size(n);
+        void* area = mmap(nullptr, page + 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (area == MAP_FAILED)
+            throw std::bad_alloc();
+        char* base = static_cast<char*>(area);
+        char* data = base + page;
+        if (mprotect(base, page, PROT_READ | PROT_WRITE) != 0) {
+            munmap(base, page + 2 * bytes);
+            throw std::bad_alloc();
+        }
+        bool mirrored = map_twice(data, bytes);
+        if (!mirrored && mmap(data, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            munmap(base, page + 2 * bytes);
+            throw std::bad_alloc();
+        }
+        header(data)->mirrored = mirrored;
+        header(data)->bytes = bytes;
+        return reinterpret_cast<T*>(data);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(reinterpret_cast<char*>(p) - page_size(), page_size() + 2 * mapping_size(n));
+    }
+
+    // true if p[n] is the same memory as p[0], i.e. n elements exactly fill the double-mapped pages
+    bool is_mirrored(const T* p, size_t n) const noexcept {
+        const mapping_header* info = header(p);
+        return info->mirrored && info->bytes == n * sizeof(T);
+    }
+    // the number of elements that fill the pages used by an allocation of n elements
+    static size_t mirrored_capacity(size_t n) noexcept {
+        return (page_size() % sizeof(T) == 0) ? mapping_size(n) / sizeof(T) : n;
+    }
+#else
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    void deallocate(T* p, [[maybe_unused]] size_t n) noexcept {
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    bool is_mirrored([[maybe_unused]] const T* p, [[maybe_unused]] size_t n) const noexcept {
+        return false;
+    }
+    static size_t mirrored_capacity(size_t n) noexcept {
+        return n;
+    }
+#endif
+
+    template <class U>
+    bool operator==(const mirrored_allocator<U>&) const noexcept {
+        return true;
+    }
+    template <class U>
+    bool operator!=(const mirrored_allocator<U>&) const noexcept {
+        return false;
+    }
+
+private:
+#if defined(__linux__)
+    struct mapping_header {
+        bool mirrored;
+        size_t bytes;
+    };
+
+    static size_t page_size() noexcept {
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+    static size_t mapping_size(size_t n) noexcept {
+        const size_t page = page_size();
+        const size_t bytes = (n == 0 ? 1 : n) * sizeof(T);
+        return (bytes + page - 1) / page * page;
+    }
+    // the page in front of the data keeps track of how the data was mapped
+    static mapping_header* header(const void* p) noexcept {
+        return reinterpret_cast<mapping_header*>(const_cast<char*>(static_cast<const char*>(p)) - page_size());
+    }
+    static bool map_twice(char* data, size_t bytes) noexcept {
+        const int fd = memfd_create("circular_buffer", MFD_CLOEXEC);
+        if (fd < 0)
+            return false;
+        bool mapped = ftruncate(fd, bytes) == 0
+            && mmap(data, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+            && mmap(data + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+        close(fd);
+        return mapped;
+    }
+#endif
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "cache_line.h"
+
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class mpmc_circular_buffer {
+public:
+    static_assert(N > 0, "N must be greater than 0");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "T must be nothrow move constructible");
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    mpmc_circular_buffer(const Alloc& alloc = Alloc()) : m_allocator(alloc), m_slots(m_allocator.allocate(N)) {
+        for (size_t i = 0; i != N; ++i)
+            std::allocator_traits<slot_allocator>::construct(m_allocator, m_slots + i, i);
+    }
+    mpmc_circular_buffer(const mpmc_circular_buffer& other) = delete;
+    mpmc_circular_buffer& operator =(const mpmc_circular_buffer& other) = delete;
+
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+            size_t pos = m_head.load(std::memory_order_relaxed);
+            slot* cell;
+            for (;;) {
+                cell = m_slots + pos % N;
+                const size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const difference_type diff = static_cast<difference_type>(seq - pos);
+                if (diff == 0) {
+                    if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;
+                else
+                    pos = m_head.load(std::memory_order_relaxed);
+            }
+            ::new (static_cast<void*>(cell->storage)) T(std::forward<Args>(args)...);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+        else {
+            // a claimed slot must always be published, so a throwing constructor runs before
+            // the claim, but not while the queue is visibly full
+            const size_t pos = m_head.load(std::memory_order_relaxed);
+            if (static_cast<difference_type>(m_slots[pos % N].sequence.load(std::memory_order_acquire) - pos) < 0)
+                return false;
+            return try_emplace(T(std::forward<Args>(args)...));
+        }
+    }
+    bool try_enqueue(T&& val) {
+        return try_emplace(std::move(val));
+    }
+    bool try_enqueue(const T& val) {
+        return try_emplace(val);
+    }
+    bool try_dequeue(T& val) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        slot* cell;
+        for (;;) {
+            cell = m_slots + pos % N;
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const difference_type diff = static_cast<difference_type>(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = m_tail.load(std::memory_order_relaxed);
+        }
+        release(cell, pos, val);
+        return true;
+    }
+
+    template <typename Iter>
+    size_t try_enqueue_bulk(Iter first, size_t count) {
+        if (count == 0)
+            return 0;
+        if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)>) {
+            // a claimed slot must always be published, so throwing copies go one at a time
+            size_t done = 0;
+            for (; done != count && try_emplace(*first); ++done, ++first) {}
+            return done;
+        }
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        size_t claimed;
+        for (;;) {
+            claimed = ready_slots(pos, count, 0);
+            if (claimed == 0) {
+                const size_t seq = m_slots[pos % N].sequence.load(std::memory_order_acquire);
+                if (static_cast<difference_type>(seq - pos) < 0)
+                    return 0;
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+            else if (m_head.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+                break;
+        }
+        for (size_t i = 0; i != claimed; ++i, ++first) {
+            slot* cell = m_slots + (pos + i) % N;
+            ::new (static_cast<void*>(cell->storage)) T(*first);
+            cell->sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+    template <typename Iter>
+    size_t try_dequeue_bulk(Iter out, size_t max_count) {
+        if (max_count == 0)
+            return 0;
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        size_t claimed;
+        for (;;) {
+            claimed = ready_slots(pos, max_count, 1);
+            if (claimed == 0) {
+                const size_t seq = m_slots[pos % N].sequence.load(std::memory_order_acquire);
+                if (static_cast<difference_type>(seq - (pos + 1)) < 0)
+                    return 0;
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+            else if (m_tail.compare_exchange_weak(pos, pos + claimed, std::memory_order_relaxed))
+                break;
+        }
+        for (size_t i = 0; i != claimed; ++i, ++out)
+            release(m_slots + (pos + i) % N, pos + i, *out);
+        return claimed;
+    }
+
+    size_t size() const noexcept {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+    size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    ~mpmc_circular_buffer() noexcept {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        for (size_t pos = m_tail.load(std::memory_order_acquire); pos != head; ++pos)
+            std::launder(reinterpret_cast<T*>(m_slots[pos % N].storage))->~T();
+        for (size_t i = 0; i != N; ++i)
+            std::allocator_traits<slot_allocator>::destroy(m_allocator, m_slots + i);
+        m_allocator.deallocate(m_slots, N);
+    }
+private:
+    struct slot {
+        explicit slot(size_t seq) : sequence(seq) {}
+
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    using slot_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<slot>;
+
+    // number of consecutive slots starting at pos that are ready for a producer (offset 0) or a consumer (offset 1)
+    size_t ready_slots(size_t pos, size_t max_count, size_t offset) const noexcept {
+        size_t count = 0;
+        while (count != max_count && count != N
+            && m_slots[(pos + count) % N].sequence.load(std::memory_order_acquire) == pos + count + offset)
+            ++count;
+        return count;
+    }
+    template <typename Out>
+    void release(slot* cell, size_t pos, Out&& val) {
+        T* stored = std::launder(reinterpret_cast<T*>(cell->storage));
+        T item(std::move(*stored));
+        stored->~T();
+        cell->sequence.store(pos + N, std::memory_order_release);
+        val = std::move(item);
+    }
+
+    slot_allocator m_allocator;
+    slot* m_slots;
+
+    alignas(cache_line_size) std::atomic<size_t> m_head = 0;
+    alignas(cache_line_size) std::atomic<size_t> m_tail = 0;
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "iterators.h"
+
+// Standard algorithms for ranges of circular buffer iterators. Such a range is at most two
+// contiguous pieces of storage, so every overload runs the std algorithm on raw pointers where
+// it can use memmove, memset, memcmp or a vectorized loop. They are found by argument dependent
+// lookup: unqualified copy(a.begin(), a.end(), out) picks them, std::copy(...) does not.
+
+template <class It>
+inline constexpr bool is_circular_iterator = false;
+template <class T, size_t C>
+inline constexpr bool is_circular_iterator<circ_buff_iter<T, C>> = true;
+template <class T, size_t C>
+inline constexpr bool is_circular_iterator<circ_buff_const_iter<T, C>> = true;
+
+// calls f(from, n, to) for aligned pieces of two segmented ranges of the same length
+template <class A, class B, class F>
+constexpr bool zip_segments(std::pair<std::span<A>, std::span<A>> lhs, std::pair<std::span<B>, std::span<B>> rhs, F f) {
+    std::span<A> from[] = { lhs.first, lhs.second };
+    std::span<B> to[] = { rhs.first, rhs.second };
+    size_t i = 0;
+    size_t j = 0;
+    while (i != 2 && j != 2) {
+        if (from[i].empty()) {
+            ++i;
+            continue;
+        }
+        if (to[j].empty()) {
+            ++j;
+            continue;
+        }
+        const size_t n = std::min(from[i].size(), to[j].size());
+        if (!f(from[i].data(), n, to[j].data()))
+            return false;
+        from[i] = from[i].subspan(n);
+        to[j] = to[j].subspan(n);
+    }
+    return true;
+}
+
+// as for std::copy, [out, out + (last - first)) must already hold elements of the buffer;
+// segments() asserts that the range at least fits in the storage
+template <class U, template <class, size_t> class Iter, class T, size_t C>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr Iter<T, C> copy(U* first, U* last, Iter<T, C> out) {
+    Iter<T, C> end = out;
+    end += last - first;
+    const auto [one, two] = out.segments(end);
+    std::copy(first, first + one.size(), one.data());
+    std::copy(first + one.size(), last, two.data());
+    return end;
+}
+
+template <template <class, size_t> class Iter, class T, size_t C, class OutputIt>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr OutputIt copy(Iter<T, C> first, Iter<T, C> last, OutputIt out) {
+    if constexpr (is_circular_iterator<OutputIt>) {
+        OutputIt end = out;
+        end += last - first;
+        zip_segments(first.segments(last), out.segments(end), [](auto* from, size_t n, auto* to) {
+            std::copy(from, from + n, to);
+            return true;
+        });
+        return end;
+    }
+    else {
+        const auto [one, two] = first.segments(last);
+        out = std::copy(one.data(), one.data() + one.size(), out);
+        return std::copy(two.data(), two.data() + two.size(), out);
+    }
+}
+
+template <template <class, size_t> class Iter, class T, size_t C, class V>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr void fill(Iter<T, C> first, Iter<T, C> last, const V& value) {
+    const auto [one, two] = first.segments(last);
+    std::fill(one.data(), one.data() + one.size(), value);
+    std::fill(two.data(), two.data() + two.size(), value);
+}
+
+// std::find does not use memchr, so bytes are searched with it directly
+template <class T, class V>
+constexpr size_t find_in(std::span<T> piece, const V& value) {
+    if constexpr (sizeof(T) == 1 && std::is_integral_v<T> && std::is_integral_v<V>) {
+        if (!std::is_constant_evaluated()) {
+            if (static_cast<T>(value) != value)
+                return piece.size();
+            const void* found = std::memchr(piece.data(), static_cast<unsigned char>(value), piece.size());
+            return found == nullptr ? piece.size() : static_cast<const T*>(found) - piece.data();
+        }
+    }
+    return std::find(piece.data(), piece.data() + piece.size(), value) - piece.data();
+}
+
+template <template <class, size_t> class Iter, class T, size_t C, class V>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr Iter<T, C> find(Iter<T, C> first, Iter<T, C> last, const V& value) {
+    const auto [one, two] = first.segments(last);
+    const size_t found = find_in(one, value);
+    if (found != one.size())
+        return first += found;
+    return first += one.size() + find_in(two, value);
+}
+
+template <template <class, size_t> class Iter, class T, size_t C, class InputIt>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr bool equal(Iter<T, C> first1, Iter<T, C> last1, InputIt first2) {
+    if constexpr (is_circular_iterator<InputIt>) {
+        InputIt last2 = first2;
+        last2 += last1 - first1;
+        return zip_segments(first1.segments(last1), first2.segments(last2), [](auto* lhs, size_t n, auto* rhs) {
+            return std::equal(lhs, lhs + n, rhs);
+        });
+    }
+    else if constexpr (std::forward_iterator<InputIt>) {
+        const auto [one, two] = first1.segments(last1);
+        if (!std::equal(one.data(), one.data() + one.size(), first2))
+            return false;
+        std::advance(first2, one.size());
+        return std::equal(two.data(), two.data() + two.size(), first2);
+    }
+    else {
+        // a single pass iterator cannot be copied and advanced again
+        for (; first1 != last1; ++first1, ++first2) {
+            if (!(*first1 == *first2))
+                return false;
+        }
+        return true;
+    }
+}
+template <template <class, size_t> class Iter, class T, size_t C, class InputIt>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr bool equal(Iter<T, C> first1, Iter<T, C> last1, InputIt first2, InputIt last2) {
+    if constexpr (std::forward_iterator<InputIt>) {
+        if (std::distance(first2, last2) != last1 - first1)
+            return false;
+        return equal(first1, last1, first2);
+    }
+    else {
+        // the length of a single pass range is only known once it is consumed
+        for (; first1 != last1; ++first1, ++first2) {
+            if (first2 == last2 || !(*first1 == *first2))
+                return false;
+        }
+        return first2 == last2;
+    }
+}
+
+template <template <class, size_t> class Iter, class T, size_t C, class V>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr V accumulate(Iter<T, C> first, Iter<T, C> last, V init) {
+    const auto [one, two] = first.segments(last);
+    init = std::accumulate(one.data(), one.data() + one.size(), std::move(init));
+    return std::accumulate(two.data(), two.data() + two.size(), std::move(init));
+}
+template <template <class, size_t> class Iter, class T, size_t C, class V, class BinaryOp>
+    requires is_circular_iterator<Iter<T, C>>
+constexpr V accumulate(Iter<T, C> first, Iter<T, C> last, V init, BinaryOp op) {
+    const auto [one, two] = first.segments(last);
+    init = std::accumulate(one.data(), one.data() + one.size(), std::move(init), op);
+    return std::accumulate(two.data(), two.data() + two.size(), std::move(init), op);
+}
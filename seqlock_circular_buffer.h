@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "cache_line.h"
+#include "seqlock_slot.h"
+
+// Overwriting ring with one writer that never waits and any number of readers that never
+// block it, for telemetry where readers want the latest values rather than every value.
+// Every slot is a seqlock stamped with the sequence number of its value: readers copy
+// optimistically and drop a copy the writer tore, readers write nothing shared, so they
+// scale with the core count. T must be trivially copyable.
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class seqlock_circular_buffer {
+    static_assert(N > 0, "N must be greater than 0");
+
+    using slot = seqlock_slot<T>;
+    using slot_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<slot>;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+
+    explicit seqlock_circular_buffer(const Alloc& alloc = Alloc())
+        : m_allocator(alloc) {
+        m_slots = std::allocator_traits<slot_allocator>::allocate(m_allocator, N);
+        for (size_t i = 0; i != N; ++i)
+            std::allocator_traits<slot_allocator>::construct(m_allocator, m_slots + i);
+    }
+    seqlock_circular_buffer(const seqlock_circular_buffer&) = delete;
+    seqlock_circular_buffer& operator =(const seqlock_circular_buffer&) = delete;
+    ~seqlock_circular_buffer() noexcept {
+        for (size_t i = 0; i != N; ++i)
+            std::allocator_traits<slot_allocator>::destroy(m_allocator, m_slots + i);
+        std::allocator_traits<slot_allocator>::deallocate(m_allocator, m_slots, N);
+    }
+
+    // writer side, overwrites the oldest value once the ring is full
+    void push(const T& val) noexcept {
+        const uint64_t head = m_head.load(std::memory_order_relaxed);
+        m_slots[head % N].store(val, head);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    // reader side, safe from any number of threads
+    // false when seq is not published yet or was already overwritten, val is untouched then
+    bool try_read(uint64_t seq, T& val) const noexcept {
+        if (seq >= m_head.load(std::memory_order_acquire))
+            return false;
+        return m_slots[seq % N].try_load(val, seq);
+    }
+    // the newest value, false while nothing is published
+    bool latest(T& val) const noexcept {
+        for (uint64_t head = m_head.load(std::memory_order_acquire); head != 0; head = m_head.load(std::memory_order_acquire)) {
+            if (m_slots[(head - 1) % N].try_load(val, head - 1))
+                return true;
+        }
+        return false;
+    }
+    // copies the newest values, at most max, oldest first, and returns how many. The copies
+    // are consecutive and end with the newest value published when the read started; values
+    // the writer overwrote while they were copied are dropped together with everything older.
+    size_t snapshot(T* out, size_t max) const noexcept {
+        for (;;) {
+            const uint64_t head = m_head.load(std::memory_order_acquire);
+            size_t count = 0;
+            for (uint64_t seq = head - std::min<uint64_t>({ head, max, N }); seq != head; ++seq) {
+                if (m_slots[seq % N].try_load_in_place(out[count], seq))
+                    ++count;
+                else
+                    count = 0;
+            }
+            // only a writer that lapped the whole copy leaves nothing
+            if (count != 0 || head == 0 || max == 0)
+                return count;
+        }
+    }
+
+    // sequence number of the next pushed value, also how many were pushed
+    uint64_t next_seq() const noexcept {
+        return m_head.load(std::memory_order_acquire);
+    }
+    size_t size() const noexcept {
+        return std::min<uint64_t>(next_seq(), N);
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return next_seq() == 0;
+    }
+
+private:
+    [[no_unique_address]] slot_allocator m_allocator;
+    slot* m_slots = nullptr;
+
+    // written by the writer only
+    alignas(cache_line_size) std::atomic<uint64_t> m_head{ 0 };
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <class T, size_t N, class Alloc>
+class seqlock_circular_buffer;
+
+// One value guarded by a sequence lock, for a single writer and any number of readers that
+// must never block it. The value is kept in atomic words, so a reader racing with the writer
+// gets a torn copy instead of a data race, and the stamp around the copy tells it to drop it.
+// Release stores and acquire loads of the words replace the usual fences; on x86 they are
+// plain moves. The stamp is 2 * version + 2 once version is stored and odd while it is being
+// written; 0 means the slot was never written.
+template <class T>
+class seqlock_slot {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    static constexpr size_t word_count = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // writer side
+    void store(const T& val, size_t version) noexcept {
+        const char* bytes = reinterpret_cast<const char*>(&val);
+        m_stamp.store(2 * version + 1, std::memory_order_relaxed);
+        // a reader that sees any new word also sees the odd stamp
+        for (size_t i = 0; i != word_count; ++i) {
+            uint64_t word = 0;
+            std::memcpy(&word, bytes + i * sizeof(uint64_t), word_size(i));
+            m_words[i].store(word, std::memory_order_release);
+        }
+        m_stamp.store(2 * version + 2, std::memory_order_release);
+    }
+
+    // reader side, true when the slot held exactly version for the whole copy, val is left
+    // untouched otherwise
+    bool try_load(T& val, size_t version) const noexcept {
+        const size_t stamp = m_stamp.load(std::memory_order_acquire);
+        if (stamp != 2 * version + 2)
+            return false;
+        uint64_t words[word_count];
+        for (size_t i = 0; i != word_count; ++i)
+            words[i] = m_words[i].load(std::memory_order_acquire);
+        if (m_stamp.load(std::memory_order_relaxed) != stamp)
+            return false;
+        char* bytes = reinterpret_cast<char*>(&val);
+        for (size_t i = 0; i != word_count; ++i)
+            std::memcpy(bytes + i * sizeof(uint64_t), &words[i], word_size(i));
+        return true;
+    }
+
+private:
+    template <class, size_t, class>
+    friend class seqlock_circular_buffer;
+
+    // copies straight into val, which holds garbage after a false return; for callers that
+    // drop the destination themselves, like snapshot() filling its output array
+    bool try_load_in_place(T& val, size_t version) const noexcept {
+        const size_t stamp = m_stamp.load(std::memory_order_acquire);
+        if (stamp != 2 * version + 2)
+            return false;
+        char* bytes = reinterpret_cast<char*>(&val);
+        // acquire keeps the second stamp load after the copy
+        for (size_t i = 0; i != word_count; ++i) {
+            const uint64_t word = m_words[i].load(std::memory_order_acquire);
+            std::memcpy(bytes + i * sizeof(uint64_t), &word, word_size(i));
+        }
+        return m_stamp.load(std::memory_order_relaxed) == stamp;
+    }
+
+    // word by word copies, a staging array would be read back with wider loads than it was
+    // written with and stall store forwarding
+    static constexpr size_t word_size(size_t i) noexcept {
+        return i + 1 != word_count ? sizeof(uint64_t) : sizeof(T) - i * sizeof(uint64_t);
+    }
+
+    std::atomic<size_t> m_stamp{ 0 };
+    std::atomic<uint64_t> m_words[word_count];
+};
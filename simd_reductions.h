@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include "segmented_algorithms.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CIRCULAR_BUFFER_SIMD_X86 1
+#else
+#define CIRCULAR_BUFFER_SIMD_X86 0
+#endif
+
+// Vectorized sum, min, max and dot product over the contents of a buffer. The kernels use
+// GCC vector extensions and are built for SSE2, AVX2 and AVX-512; the widest one the CPU
+// supports is picked at run time. Other compilers and element types get the scalar loop.
+// Floating point sums are added in a different order than std::accumulate, so the last bits
+// may differ, and a NaN makes min and max unspecified.
+
+enum class simd_level { scalar, sse2, avx2, avx512 };
+
+inline simd_level simd_cpu_level() noexcept {
+#if CIRCULAR_BUFFER_SIMD_X86
+    static const simd_level level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+            return simd_level::avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return simd_level::avx2;
+        return __builtin_cpu_supports("sse2") ? simd_level::sse2 : simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+enum class simd_op { sum, min, max };
+
+// vectors go by reference: a callee built without AVX would expect them in a different place
+template <simd_op Op, class V>
+constexpr void simd_combine(V& acc, const V& value) noexcept {
+    if constexpr (Op == simd_op::sum)
+        acc = acc + value;
+    else if constexpr (Op == simd_op::min)
+        acc = value < acc ? value : acc;
+    else
+        acc = acc < value ? value : acc;
+}
+
+template <simd_op Op, class T>
+T scalar_reduce(const T* data, size_t n, T init) noexcept {
+    for (size_t i = 0; i != n; ++i)
+        simd_combine<Op>(init, data[i]);
+    return init;
+}
+template <class T>
+T scalar_dot(const T* lhs, const T* rhs, size_t n, T init) noexcept {
+    for (size_t i = 0; i != n; ++i)
+        init += lhs[i] * rhs[i];
+    return init;
+}
+
+#if CIRCULAR_BUFFER_SIMD_X86
+template <class T>
+inline constexpr bool simd_vectorizable = !std::is_same_v<T, bool> && sizeof(T) <= 8
+    && (std::is_integral_v<T> || std::is_same_v<T, float> || std::is_same_v<T, double>);
+
+// four independent accumulators hide the latency of the vector adds
+template <simd_op Op, size_t Bytes, class T>
+[[gnu::always_inline]] inline T simd_reduce_kernel(const T* data, size_t n, T init) noexcept {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    constexpr size_t lanes = Bytes / sizeof(T);
+    if (n < 4 * lanes)
+        return scalar_reduce<Op>(data, n, init);
+    vec acc[4];
+    for (size_t k = 0; k != 4; ++k)
+        std::memcpy(&acc[k], data + k * lanes, Bytes);
+    size_t i = 4 * lanes;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        for (size_t k = 0; k != 4; ++k) {
+            vec v;
+            std::memcpy(&v, data + i + k * lanes, Bytes);
+            simd_combine<Op>(acc[k], v);
+        }
+    }
+    simd_combine<Op>(acc[0], acc[1]);
+    simd_combine<Op>(acc[2], acc[3]);
+    simd_combine<Op>(acc[0], acc[2]);
+    T result = acc[0][0];
+    for (size_t l = 1; l != lanes; ++l)
+        simd_combine<Op>(result, static_cast<T>(acc[0][l]));
+    result = scalar_reduce<Op>(data + i, n - i, result);
+    simd_combine<Op>(init, result);
+    return init;
+}
+template <size_t Bytes, class T>
+[[gnu::always_inline]] inline T simd_dot_kernel(const T* lhs, const T* rhs, size_t n, T init) noexcept {
+    typedef T vec __attribute__((vector_size(Bytes)));
+    constexpr size_t lanes = Bytes / sizeof(T);
+    vec acc[4] = {};
+    size_t i = 0;
+    for (; i + 4 * lanes <= n; i += 4 * lanes) {
+        for (size_t k = 0; k != 4; ++k) {
+            vec a;
+            vec b;
+            std::memcpy(&a, lhs + i + k * lanes, Bytes);
+            std::memcpy(&b, rhs + i + k * lanes, Bytes);
+            acc[k] += a * b;
+        }
+    }
+    acc[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    T result = T();
+    for (size_t l = 0; l != lanes; ++l)
+        result += acc[0][l];
+    return init + scalar_dot(lhs + i, rhs + i, n - i, result);
+}
+
+template <simd_op Op, class T>
+__attribute__((target("avx2"))) T simd_reduce_avx2(const T* data, size_t n, T init) noexcept {
+    return simd_reduce_kernel<Op, 32>(data, n, init);
+}
+template <simd_op Op, class T>
+__attribute__((target("avx512f,avx512bw"))) T simd_reduce_avx512(const T* data, size_t n, T init) noexcept {
+    return simd_reduce_kernel<Op, 64>(data, n, init);
+}
+template <class T>
+__attribute__((target("avx2"))) T simd_dot_avx2(const T* lhs, const T* rhs, size_t n, T init) noexcept {
+    return simd_dot_kernel<32>(lhs, rhs, n, init);
+}
+template <class T>
+__attribute__((target("avx512f,avx512bw"))) T simd_dot_avx512(const T* lhs, const T* rhs, size_t n, T init) noexcept {
+    return simd_dot_kernel<64>(lhs, rhs, n, init);
+}
+#endif
+
+// level is capped at what the CPU supports, a lower one can be asked for to compare kernels
+template <simd_op Op, class T>
+T simd_reduce(const T* data, size_t n, T init, simd_level level = simd_cpu_level()) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "reductions need an arithmetic type");
+#if CIRCULAR_BUFFER_SIMD_X86
+    if constexpr (simd_vectorizable<T>) {
+        switch (std::min(level, simd_cpu_level())) {
+        case simd_level::avx512:
+            return simd_reduce_avx512<Op>(data, n, init);
+        case simd_level::avx2:
+            return simd_reduce_avx2<Op>(data, n, init);
+        case simd_level::sse2:
+            return simd_reduce_kernel<Op, 16>(data, n, init);
+        default:
+            break;
+        }
+    }
+#endif
+    return scalar_reduce<Op>(data, n, init);
+}
+template <class T>
+T simd_dot(const T* lhs, const T* rhs, size_t n, T init, simd_level level = simd_cpu_level()) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "reductions need an arithmetic type");
+#if CIRCULAR_BUFFER_SIMD_X86
+    if constexpr (simd_vectorizable<T>) {
+        switch (std::min(level, simd_cpu_level())) {
+        case simd_level::avx512:
+            return simd_dot_avx512(lhs, rhs, n, init);
+        case simd_level::avx2:
+            return simd_dot_avx2(lhs, rhs, n, init);
+        case simd_level::sse2:
+            return simd_dot_kernel<16>(lhs, rhs, n, init);
+        default:
+            break;
+        }
+    }
+#endif
+    return scalar_dot(lhs, rhs, n, init);
+}
+
+template <class Buffer>
+typename Buffer::value_type window_sum(const Buffer& buffer, simd_level level = simd_cpu_level()) noexcept {
+    using T = typename Buffer::value_type;
+    const auto one = buffer.array_one();
+    const auto two = buffer.array_two();
+    return simd_reduce<simd_op::sum>(two.data(), two.size(), simd_reduce<simd_op::sum>(one.data(), one.size(), T(), level), level);
+}
+template <class Buffer>
+typename Buffer::value_type window_min(const Buffer& buffer, simd_level level = simd_cpu_level()) {
+    if (buffer.empty())
+        throw std::out_of_range("buffer is empty");
+    const auto one = buffer.array_one();
+    const auto two = buffer.array_two();
+    return simd_reduce<simd_op::min>(two.data(), two.size(), simd_reduce<simd_op::min>(one.data(), one.size(), one[0], level), level);
+}
+template <class Buffer>
+typename Buffer::value_type window_max(const Buffer& buffer, simd_level level = simd_cpu_level()) {
+    if (buffer.empty())
+        throw std::out_of_range("buffer is empty");
+    const auto one = buffer.array_one();
+    const auto two = buffer.array_two();
+    return simd_reduce<simd_op::max>(two.data(), two.size(), simd_reduce<simd_op::max>(one.data(), one.size(), one[0], level), level);
+}
+// the buffers may have wrapped at different points, so their segments are paired up piece by piece
+template <class Buffer1, class Buffer2>
+typename Buffer1::value_type window_dot(const Buffer1& lhs, const Buffer2& rhs, simd_level level = simd_cpu_level()) {
+    using T = typename Buffer1::value_type;
+    static_assert(std::is_same_v<T, typename Buffer2::value_type>, "both buffers need the same element type");
+    if (lhs.size() != rhs.size())
+        throw std::invalid_argument("buffers differ in size");
+    T result = T();
+    zip_segments(lhs.cbegin().segments(lhs.cend()), rhs.cbegin().segments(rhs.cend()), [&](const T* a, size_t n, const T* b) {
+        result = simd_dot(a, b, n, result, level);
+        return true;
+    });
+    return result;
+}
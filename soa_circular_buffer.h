@@ -0,0 +1,357 @@
+#pragma once
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+template <class Row, size_t N, class Alloc = std::allocator<unsigned char>>
+class soa_circular_buffer;
+
+// Circular buffer of records stored column by column: every column is its own array of N
+// elements and all of them share one head and tail. Scanning a single column touches only
+// that column's memory. Like circular_buffer, pushing into a full buffer overwrites the oldest row.
+template <class... Ts, size_t N, class Alloc>
+class soa_circular_buffer<std::tuple<Ts...>, N, Alloc> {
+    static_assert(N > 0, "N must be greater than 0");
+    static_assert(sizeof...(Ts) > 0, "a record needs at least one column");
+
+    template <class U>
+    using column_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+    using indices = std::index_sequence_for<Ts...>;
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    template <size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    // iterator over rows, dereferencing yields a tuple of references into the columns
+    template <bool Const>
+    class row_iterator {
+        using buffer_pointer = std::conditional_t<Const, const soa_circular_buffer*, soa_circular_buffer*>;
+
+    public:
+        using value_type = std::tuple<Ts...>;
+        using reference = std::conditional_t<Const, std::tuple<const Ts&...>, std::tuple<Ts&...>>;
+        using difference_type = ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        row_iterator() = default;
+        row_iterator(buffer_pointer buffer, size_t offset)
+            : m_buffer(buffer), m_offset(offset) {}
+        operator row_iterator<true>() const noexcept {
+            return row_iterator<true>(m_buffer, m_offset);
+        }
+
+        reference operator *() const {
+            return m_buffer->row(m_offset, indices{});
+        }
+        reference operator [](difference_type n) const {
+            return m_buffer->row(m_offset + n, indices{});
+        }
+
+        row_iterator& operator ++() noexcept {
+            ++m_offset;
+            return *this;
+        }
+        row_iterator operator ++(int) noexcept {
+            row_iterator it = *this;
+            ++m_offset;
+            return it;
+        }
+        row_iterator& operator --() noexcept {
+            --m_offset;
+            return *this;
+        }
+        row_iterator operator --(int) noexcept {
+            row_iterator it = *this;
+            --m_offset;
+            return it;
+        }
+        row_iterator& operator +=(difference_type n) noexcept {
+            m_offset += n;
+            return *this;
+        }
+        row_iterator& operator -=(difference_type n) noexcept {
+            m_offset -= n;
+            return *this;
+        }
+        friend row_iterator operator +(row_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend row_iterator operator +(difference_type n, row_iterator it) noexcept {
+            return it += n;
+        }
+        friend row_iterator operator -(row_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator -(const row_iterator& lhs, const row_iterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.m_offset) - static_cast<difference_type>(rhs.m_offset);
+        }
+        friend bool operator ==(const row_iterator& lhs, const row_iterator& rhs) noexcept {
+            return lhs.m_offset == rhs.m_offset;
+        }
+        friend auto operator <=>(const row_iterator& lhs, const row_iterator& rhs) noexcept {
+            return lhs.m_offset <=> rhs.m_offset;
+        }
+
+    private:
+        buffer_pointer m_buffer = nullptr;
+        size_t m_offset = 0;
+    };
+
+    using iterator = row_iterator<false>;
+    using const_iterator = row_iterator<true>;
+
+    explicit soa_circular_buffer(const Alloc& alloc = Alloc())
+        : m_allocator(alloc) {
+        allocate_columns(indices{});
+    }
+    soa_circular_buffer(const soa_circular_buffer& other)
+        : soa_circular_buffer(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_allocator)) {
+        for (size_t i = 0; i != other.m_size; ++i)
+            std::apply([this](const Ts&... values) { push_back(values...); }, other[i]);
+    }
+    soa_circular_buffer(soa_circular_buffer&& other) noexcept
+        : m_allocator(other.m_allocator), m_columns(other.m_columns), m_tail(other.m_tail), m_size(other.m_size) {
+        // other gets new columns on its next push
+        other.m_columns = {};
+        other.m_tail = 0;
+        other.m_size = 0;
+    }
+    soa_circular_buffer& operator =(soa_circular_buffer other) noexcept {
+        swap(other);
+        return *this;
+    }
+    ~soa_circular_buffer() noexcept {
+        clear();
+        deallocate_columns(indices{});
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+    iterator end() noexcept {
+        return iterator(this, m_size);
+    }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(this, m_size);
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // the oldest part of column I, up to the end of its storage
+    template <size_t I>
+    std::span<column_type<I>> array_one() noexcept {
+        return std::span<column_type<I>>(column<I>() + m_tail, first_part());
+    }
+    // the part of column I that wrapped around to the start of its storage
+    template <size_t I>
+    std::span<column_type<I>> array_two() noexcept {
+        return std::span<column_type<I>>(column<I>(), m_size - first_part());
+    }
+    template <size_t I>
+    std::span<const column_type<I>> array_one() const noexcept {
+        return std::span<const column_type<I>>(column<I>() + m_tail, first_part());
+    }
+    template <size_t I>
+    std::span<const column_type<I>> array_two() const noexcept {
+        return std::span<const column_type<I>>(column<I>(), m_size - first_part());
+    }
+
+    reference operator [](size_t offset) noexcept {
+        return row(offset, indices{});
+    }
+    const_reference operator [](size_t offset) const noexcept {
+        return row(offset, indices{});
+    }
+    reference at(size_t offset) {
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return row(offset, indices{});
+    }
+    const_reference at(size_t offset) const {
+        if (offset >= m_size)
+            throw std::out_of_range("Index of out range");
+        return row(offset, indices{});
+    }
+    template <size_t I>
+    column_type<I>& get(size_t offset) noexcept {
+        return column<I>()[slot(offset)];
+    }
+    template <size_t I>
+    const column_type<I>& get(size_t offset) const noexcept {
+        return column<I>()[slot(offset)];
+    }
+    reference front() noexcept {
+        return row(0, indices{});
+    }
+    reference back() noexcept {
+        return row(m_size - 1, indices{});
+    }
+    const_reference front() const noexcept {
+        return row(0, indices{});
+    }
+    const_reference back() const noexcept {
+        return row(m_size - 1, indices{});
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "one value per column");
+        if (m_size == N) {
+            // built before touching the oldest row, so args may refer to it
+            value_type record(std::forward<Args>(args)...);
+            assign_row(m_tail, indices{}, std::move(record));
+            m_tail = next(m_tail);
+        }
+        else {
+            if (column<0>() == nullptr)
+                allocate_columns(indices{});
+            construct_row(slot(m_size), indices{}, std::forward<Args>(args)...);
+            ++m_size;
+        }
+    }
+    void push_back(const Ts&... values) {
+        emplace_back(values...);
+    }
+    void push_back(const value_type& record) {
+        std::apply([this](const Ts&... values) { emplace_back(values...); }, record);
+    }
+
+    void pop_front() {
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        destroy_row(m_tail, indices{});
+        m_tail = next(m_tail);
+        --m_size;
+    }
+    void pop_back() {
+        if (m_size == 0)
+            throw std::out_of_range("buffer is empty");
+        destroy_row(slot(m_size - 1), indices{});
+        --m_size;
+    }
+    void clear() noexcept {
+        while (m_size != 0) {
+            destroy_row(m_tail, indices{});
+            m_tail = next(m_tail);
+            --m_size;
+        }
+        m_tail = 0;
+    }
+    void swap(soa_circular_buffer& other) noexcept {
+        std::swap(m_allocator, other.m_allocator);
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_tail, other.m_tail);
+        std::swap(m_size, other.m_size);
+    }
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+    bool full() const noexcept {
+        return m_size == N;
+    }
+
+private:
+    template <size_t I>
+    column_type<I>* column() const noexcept {
+        return std::get<I>(m_columns);
+    }
+    size_t next(size_t index) const noexcept {
+        return index + 1 == N ? 0 : index + 1;
+    }
+    size_t slot(size_t offset) const noexcept {
+        const size_t index = m_tail + offset;
+        return index < N ? index : index - N;
+    }
+    size_t first_part() const noexcept {
+        return std::min(m_size, N - m_tail);
+    }
+
+    template <size_t... Is>
+    reference row(size_t offset, std::index_sequence<Is...>) noexcept {
+        const size_t index = slot(offset);
+        return reference(column<Is>()[index]...);
+    }
+    template <size_t... Is>
+    const_reference row(size_t offset, std::index_sequence<Is...>) const noexcept {
+        const size_t index = slot(offset);
+        return const_reference(column<Is>()[index]...);
+    }
+
+    template <size_t... Is, typename... Args>
+    void construct_row(size_t index, std::index_sequence<Is...>, Args&&... args) {
+        size_t built = 0;
+        try {
+            ((construct<Is>(index, std::forward<Args>(args)), ++built), ...);
+        }
+        catch (...) {
+            ((Is < built ? destroy<Is>(index) : void()), ...);
+            throw;
+        }
+    }
+    template <size_t... Is>
+    void assign_row(size_t index, std::index_sequence<Is...>, value_type&& record) {
+        ((column<Is>()[index] = std::move(std::get<Is>(record))), ...);
+    }
+    template <size_t... Is>
+    void destroy_row(size_t index, std::index_sequence<Is...>) noexcept {
+        (destroy<Is>(index), ...);
+    }
+    template <size_t I, typename Arg>
+    void construct(size_t index, Arg&& arg) {
+        column_allocator<column_type<I>> allocator(m_allocator);
+        std::allocator_traits<column_allocator<column_type<I>>>::construct(allocator, column<I>() + index, std::forward<Arg>(arg));
+    }
+    template <size_t I>
+    void destroy(size_t index) noexcept {
+        column_allocator<column_type<I>> allocator(m_allocator);
+        std::allocator_traits<column_allocator<column_type<I>>>::destroy(allocator, column<I>() + index);
+    }
+
+    template <size_t... Is>
+    void allocate_columns(std::index_sequence<Is...>) {
+        try {
+            ((std::get<Is>(m_columns) = column_allocator<column_type<Is>>(m_allocator).allocate(N)), ...);
+        }
+        catch (...) {
+            deallocate_columns(indices{});
+            throw;
+        }
+    }
+    template <size_t... Is>
+    void deallocate_columns(std::index_sequence<Is...>) noexcept {
+        ((std::get<Is>(m_columns) != nullptr ? column_allocator<column_type<Is>>(m_allocator).deallocate(std::get<Is>(m_columns), N) : void()), ...);
+        m_columns = {};
+    }
+
+    Alloc m_allocator;
+    std::tuple<Ts*...> m_columns{};
+    size_t m_tail = 0;
+    size_t m_size = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include "cache_line.h"
+
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class spsc_circular_buffer {
+public:
+    static_assert(N > 0, "N must be greater than 0");
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+
+    spsc_circular_buffer(const Alloc& alloc = Alloc()) : m_allocator(alloc), m_buffer(m_allocator.allocate(N)) {}
+    spsc_circular_buffer(const spsc_circular_buffer& other) = delete;
+    spsc_circular_buffer& operator =(const spsc_circular_buffer& other) = delete;
+
+    // producer side
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail_cache == N) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tail_cache == N)
+                return false;
+        }
+        std::allocator_traits<Alloc>::construct(m_allocator, m_buffer + head % N, std::forward<Args>(args)...);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    bool try_push(T&& val) {
+        return try_emplace(std::move(val));
+    }
+    bool try_push(const T& val) {
+        return try_emplace(val);
+    }
+
+    // consumer side
+    bool try_pop(T& val) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head_cache) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (tail == m_head_cache)
+                return false;
+        }
+        pointer slot = m_buffer + tail % N;
+        val = std::move(*slot);
+        std::allocator_traits<Alloc>::destroy(m_allocator, slot);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const noexcept {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return m_head.load(std::memory_order_acquire) - tail;
+    }
+    size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+    bool full() const noexcept {
+        return size() == N;
+    }
+
+    ~spsc_circular_buffer() noexcept {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        for (size_t it = m_tail.load(std::memory_order_acquire); it != head; ++it)
+            std::allocator_traits<Alloc>::destroy(m_allocator, m_buffer + it % N);
+        m_allocator.deallocate(m_buffer, N);
+    }
+private:
+    Alloc m_allocator;
+    pointer m_buffer;
+
+    // written by the producer, m_tail_cache is its private copy of the consumer index
+    alignas(cache_line_size) std::atomic<size_t> m_head = 0;
+    size_t m_tail_cache = 0;
+
+    // written by the consumer, m_head_cache is its private copy of the producer index
+    alignas(cache_line_size) std::atomic<size_t> m_tail = 0;
+    size_t m_head_cache = 0;
+};
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// The part of the MSVC CppUnitTest framework that tests.cpp uses, so the tests also build with
+// GCC and Clang. A TEST_CLASS registers itself before main runs and collects its TEST_METHODs
+// while it is constructed; run_tests creates each class once and runs its methods in order.
+namespace test_shim {
+    class test_class;
+
+    inline test_class*& constructed_class() {
+        static test_class* current = nullptr;
+        return current;
+    }
+
+    class test_class {
+    public:
+        test_class() {
+            constructed_class() = this;
+        }
+        test_class(const test_class&) = delete;
+        test_class& operator =(const test_class&) = delete;
+
+        std::vector<std::pair<const char*, std::function<void()>>> methods;
+    };
+
+    struct method_registration {
+        method_registration(const char* name, std::function<void()> body) {
+            constructed_class()->methods.emplace_back(name, std::move(body));
+        }
+    };
+
+    struct test_result {
+        int run = 0;
+        int failed = 0;
+    };
+
+    inline std::vector<std::pair<const char*, void (*)(test_result&)>>& test_classes() {
+        static std::vector<std::pair<const char*, void (*)(test_result&)>> classes;
+        return classes;
+    }
+
+    struct class_registration {
+        class_registration(const char* name, void (*run)(test_result&)) {
+            test_classes().emplace_back(name, run);
+        }
+    };
+
+    template <class TestClass>
+    void run_class(const char* class_name, test_result& result) {
+        TestClass tests;
+        for (auto& [name, body] : tests.methods) {
+            ++result.run;
+            try {
+                body();
+            }
+            catch (const std::exception& e) {
+                ++result.failed;
+                std::printf("FAILED %s::%s: %s\n", class_name, name, e.what());
+            }
+            catch (...) {
+                ++result.failed;
+                std::printf("FAILED %s::%s: unknown exception\n", class_name, name);
+            }
+        }
+    }
+}
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+    class Assert {
+    public:
+        static void IsTrue(bool condition, const wchar_t* = nullptr) {
+            if (!condition)
+                throw std::logic_error("Assert::IsTrue failed");
+        }
+        static void IsFalse(bool condition, const wchar_t* = nullptr) {
+            if (condition)
+                throw std::logic_error("Assert::IsFalse failed");
+        }
+        template <class Expected, class Actual>
+        static void AreEqual(const Expected& expected, const Actual& actual, const wchar_t* = nullptr) {
+            if (!(expected == actual))
+                throw std::logic_error("Assert::AreEqual failed");
+        }
+        template <class Exception, class Functor>
+        static void ExpectException(Functor functor, const wchar_t* = nullptr) {
+            try {
+                functor();
+            }
+            catch (const Exception&) {
+                return;
+            }
+            catch (...) {
+                throw std::logic_error("Assert::ExpectException caught a different exception");
+            }
+            throw std::logic_error("Assert::ExpectException caught no exception");
+        }
+    };
+}}}
+
+#define TEST_SHIM_CONCAT_IMPL(a, b) a##b
+#define TEST_SHIM_CONCAT(a, b) TEST_SHIM_CONCAT_IMPL(a, b)
+
+#define TEST_CLASS(class_name) \
+    class class_name; \
+    static test_shim::class_registration TEST_SHIM_CONCAT(class_name, _registration){ #class_name, \
+        [](test_shim::test_result& result) { test_shim::run_class<class_name>(#class_name, result); } }; \
+    class class_name : public test_shim::test_class
+
+#define TEST_METHOD(method_name) \
+    test_shim::method_registration TEST_SHIM_CONCAT(method_name, _registration){ #method_name, [this] { this->method_name(); } }; \
+    void method_name()
@@ -0,0 +1,14 @@
+#include <cstdio>
+#include <cstring>
+#include "CppUnitTest.h"
+
+// runs every test class, or only the classes whose name contains the first argument
+int main(int argc, char** argv) {
+    test_shim::test_result result;
+    for (auto& [name, run] : test_shim::test_classes()) {
+        if (argc < 2 || std::strstr(name, argv[1]) != nullptr)
+            run(result);
+    }
+    std::printf("%d/%d tests passed\n", result.run - result.failed, result.run);
+    return result.failed == 0 ? 0 : 1;
+}
@@ -1,16 +1,58 @@
 #include "pch.h"
 #include "CppUnitTest.h"
 #include <vector>
+#include <list>
 #include <algorithm>
+#include <numeric>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <execution>
+#include <ranges>
 #include "..\circular buffer\circular_buffer.h"
 #include "..\circular buffer\dynamic_circular_buffer.h"
+#include "..\circular buffer\spsc_circular_buffer.h"
+#include "..\circular buffer\mpmc_circular_buffer.h"
+#include "..\circular buffer\mirrored_allocator.h"
+#include "..\circular buffer\blocking_circular_queue.h"
+#include "..\circular buffer\async_channel.h"
+#include "..\circular buffer\soa_circular_buffer.h"
+#include "..\circular buffer\inline_circular_buffer.h"
+#include "..\circular buffer\segmented_algorithms.h"
+#include "..\circular buffer\simd_reductions.h"
+#include "..\circular buffer\window_stats.h"
+#include "..\circular buffer\window_extrema.h"
+#include "..\circular buffer\time_series_buffer.h"
+#include "..\circular buffer\broadcast_circular_buffer.h"
+#include "..\circular buffer\seqlock_circular_buffer.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace buffertests
 {
+	struct counted {
+		static inline int alive = 0;
+		counted() { ++alive; }
+		counted(const counted&) { ++alive; }
+		counted& operator=(const counted&) = default;
+		~counted() { --alive; }
+	};
+
+	detached_task produce(async_channel<std::string>& channel, int count, std::vector<std::string>& log) {
+		for (int i = 0; i < count; ++i) {
+			co_await channel.push(std::to_string(i));
+			log.push_back("pushed " + std::to_string(i));
+		}
+	}
+	detached_task consume(async_channel<std::string>& channel, int count, std::vector<std::string>& log) {
+		for (int i = 0; i < count; ++i)
+			log.push_back("popped " + co_await channel.pop());
+	}
+
 	TEST_CLASS(static_buffer)
 	{
 	public:
@@ -114,6 +156,48 @@ namespace buffertests
 			circular_buffer <int, 3> a = { 1,2,3 };
 			Assert::IsTrue(a.back() == 3);
 		}
+		TEST_METHOD(test_empty)
+		{
+			circular_buffer <int, 3> a;
+			Assert::IsTrue(a.empty() && a.size() == 0 && !a.full());
+			a.push_back(1);
+			a.push_back(2);
+			Assert::IsTrue(!a.empty() && a.size() == 2 && !a.full() && a.back() == 2);
+			a.push_back(3);
+			a.push_back(4);
+			Assert::IsTrue(a.full() && a.size() == 3 && a.front() == 2 && a[2] == 4);
+		}
+		TEST_METHOD(test_lazy_construction)
+		{
+			{
+				circular_buffer <counted, 64> a;
+				Assert::IsTrue(counted::alive == 0);
+				a.push_back(counted());
+				a.push_back(counted());
+				Assert::IsTrue(counted::alive == 2);
+				a.pop_front();
+				Assert::IsTrue(counted::alive == 1);
+			}
+			Assert::IsTrue(counted::alive == 0);
+		}
+		TEST_METHOD(test_pop_front)
+		{
+			circular_buffer <int, 3> a = { 1,2,3 };
+			a.pop_front();
+			a.push_back(4);
+			a.pop_front();
+			std::vector<int> b = { 3,4 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 2);
+		}
+		TEST_METHOD(test_pop_back)
+		{
+			circular_buffer <int, 3> a = { 1,2,3 };
+			a.pop_back();
+			a.pop_back();
+			a.push_back(4);
+			std::vector<int> b = { 1,4 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 2);
+		}
 		TEST_METHOD(test_clear)
 		{
 			circular_buffer <int, 3> a = { 1,2,3 };
@@ -156,10 +240,167 @@ namespace buffertests
 			circular_buffer <int, 3> a = { 1,2,1 };
 			a.push_back(4);
 			a.push_back(std::move(4));
-			std::vector<int> b = { 4,4,1 };
+			std::vector<int> b = { 1,4,4 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
+		}
+		TEST_METHOD(test_write)
+		{
+			circular_buffer <int, 4> a = { 1,2,3 };
+			std::vector<int> origin = { 4,5 };
+			a.write(origin.data(), origin.size());
+			std::vector<int> b = { 2,3,4,5 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.array_two().size() == 1);
+		}
+		TEST_METHOD(test_write_more_than_size)
+		{
+			circular_buffer <int, 4> a = { 1,2,3,4 };
+			a.push_back(5);
+			std::vector<int> origin = { 6,7,8,9,10,11 };
+			a.write(origin.data(), origin.size());
+			std::vector<int> b = { 8,9,10,11 };
 			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
 		}
+		TEST_METHOD(test_push_back_range)
+		{
+			circular_buffer <std::string, 3> a = { "a","b","c" };
+			std::list<std::string> origin = { "d","e" };
+			a.push_back(origin.begin(), origin.end());
+			std::vector<std::string> b = { "c","d","e" };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
+		}
+		TEST_METHOD(test_array_one_two)
+		{
+			circular_buffer <int, 4> a = { 1,2,3,4 };
+			a.push_back(5);
+			std::vector<int> one(a.array_one().begin(), a.array_one().end());
+			std::vector<int> two(a.array_two().begin(), a.array_two().end());
+			std::vector<int> b = { 2,3,4 };
+			std::vector<int> c = { 5 };
+			Assert::IsTrue(one == b && two == c);
+		}
+		TEST_METHOD(test_linearize_partial)
+		{
+			circular_buffer <std::string, 4> a = { "a","b","c" };
+			a.pop_front();
+			a.pop_front();
+			a.push_back("d");
+			a.push_back("e");
+			std::span<std::string> span = a.linearize();
+			std::vector<std::string> b = { "c","d","e" };
+			Assert::IsTrue(std::equal(span.begin(), span.end(), b.begin()) && span.size() == 3);
+			a.push_back("f");
+			Assert::IsTrue(a.full() && a.back() == "f" && a.array_two().empty());
+		}
+		TEST_METHOD(test_linearize)
+		{
+			circular_buffer <int, 4> a = { 1,2,3,4 };
+			a.push_back(5);
+			a.push_back(6);
+			std::span<int> span = a.linearize();
+			std::vector<int> b = { 3,4,5,6 };
+			Assert::IsTrue(std::equal(span.begin(), span.end(), b.begin()) && span.size() == 4);
+			Assert::IsTrue(a.array_two().empty() && std::equal(a.begin(), a.end(), b.begin()));
+		}
+		TEST_METHOD(test_reject_newest)
+		{
+			circular_buffer <int, 3, std::allocator<int>, reject_newest> a;
+			Assert::IsTrue(a.push_back(1) && a.push_back(2) && a.push_back(3));
+			Assert::IsFalse(a.push_back(4));
+			Assert::IsTrue(a.front() == 1 && a.back() == 3);
+			a.pop_front();
+			std::vector<int> b = { 5,6,7 };
+			Assert::IsTrue(a.push_back(b.begin(), b.end()) == 1);
+			std::vector<int> c = { 2,3,5 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), c.begin()) && a.full());
+		}
+		TEST_METHOD(test_block_when_full)
+		{
+			circular_buffer <int, 2, std::allocator<int>, block_when_full> a;
+			a.push_back(1);
+			a.push_back(2);
+			std::atomic<bool> pushed = false;
+			std::thread producer([&] {
+				a.push_back(3);
+				pushed = true;
+			});
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			Assert::IsFalse(pushed.load());
+			a.pop_front();
+			producer.join();
+			Assert::IsTrue(pushed.load() && a.front() == 2 && a.back() == 3 && a.full());
+		}
+		TEST_METHOD(test_block_when_full_bulk)
+		{
+			using blocking = circular_buffer <int, 4, std::allocator<int>, block_when_full>;
+			static_assert(!noexcept(std::declval<const blocking&>().size()) && noexcept(std::declval<const circular_buffer<int, 4>&>().size()));
+			blocking a;
+			int b[] = { 1,2,3 };
+			Assert::IsTrue(a.write(b, 2) == 2);
+			Assert::IsTrue(a.push_back(b + 2, b + 3) == 1);
+			std::vector<int> c = { 1,2,3 };
+			Assert::IsTrue(a.size() == 3 && std::equal(a.begin(), a.end(), c.begin()));
+		}
+		TEST_METHOD(test_stats)
+		{
+			circular_buffer <int, 3, std::allocator<int>, overwrite_oldest, buffer_stats> a;
+			for (int i = 0; i < 5; ++i)
+				a.push_back(i);
+			a.pop_front();
+			std::vector<int> b = { 5,6,7,8 };
+			a.push_back(b.begin(), b.end());
+			buffer_stats_snapshot stats = a.stats();
+			Assert::IsTrue(stats.pushes == 9 && stats.pops == 1 && stats.overwrites == 5 && stats.high_water_mark == 3);
+
+			circular_buffer <int, 2, std::allocator<int>, reject_newest, atomic_buffer_stats> c;
+			c.push_back(b.begin(), b.end());
+			c.push_back(1);
+			stats = c.stats();
+			Assert::IsTrue(stats.pushes == 2 && stats.drops == 3 && stats.overwrites == 0);
+			c.reset_stats();
+			Assert::IsTrue(c.stats().drops == 0);
+
+			circular_buffer <int, 3> d = { 1,2,3 };
+			d.push_back(4);
+			Assert::IsTrue(d.stats().pushes == 0 && d.stats().overwrites == 0);
+
+			circular_buffer <int, 2, std::allocator<int>, reject_newest, atomic_buffer_stats> e;
+			e.push_back(1);
+			c.push_back(2);
+			c.swap(e);
+			Assert::IsTrue(c.stats().pushes == 1 && c.stats().drops == 0 && e.stats().pushes == 0 && e.stats().drops == 1);
+		}
+		TEST_METHOD(test_mirrored_storage)
+		{
+			circular_buffer <int, 1024, mirrored_allocator<int>> a;
+			for (int i = 0; i < 1500; ++i)
+				a.push_back(i);
+			std::vector<int> b(1024);
+			std::iota(b.begin(), b.end(), 476);
+			std::vector<int> c(a.array_one().begin(), a.array_one().end());
+			c.insert(c.end(), a.array_two().begin(), a.array_two().end());
+			Assert::IsTrue(c == b && std::equal(a.begin(), a.end(), b.begin()));
+#if defined(__linux__)
+			Assert::IsTrue(a.array_one().size() == 1024 && a.array_two().empty());
+#endif
+			std::span<int> span = a.linearize();
+			Assert::IsTrue(std::equal(span.begin(), span.end(), b.begin()) && span.size() == 1024);
+		}
+		TEST_METHOD(test_iterator_wrap)
+		{
+			circular_buffer <int, 3> a = { 1,2,3 };
+			circular_buffer <int, 4> b = { 1,2,3,4 };
+			auto a_it = a.begin();
+			auto b_it = b.begin();
+			a_it += 4;
+			b_it += 5;
+			Assert::IsTrue(*a_it == 2 && *b_it == 2);
+			--a_it;
+			--a_it;
+			b_it -= 2;
+			Assert::IsTrue(*a_it == 3 && *b_it == 4);
+		}
 	};
+
 	TEST_CLASS(dynamic_buffer)
 	{
 	public:
@@ -312,9 +553,151 @@ namespace buffertests
 			dynamic_circular_buffer <int> a = { 1,2,1 };
 			a.push_back(4);
 			a.push_back(std::move(4));
-			std::vector<int> b = { 4,4,1 };
+			std::vector<int> b = { 1,2,1,4,4 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
+		}
+		TEST_METHOD(test_write)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3,4 };
+			a.pop_front();
+			a.pop_front();
+			std::vector<int> origin = { 5,6 };
+			a.write(origin.data(), origin.size());
+			std::vector<int> b = { 3,4,5,6 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.array_two().size() == 2);
+		}
+		TEST_METHOD(test_write_more_than_size)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3,4 };
+			a.pop_front();
+			a.push_back(5);
+			std::vector<int> origin = { 6,7,8,9,10,11 };
+			a.write(origin.data(), origin.size());
+			std::vector<int> b = { 2,3,4,5,6,7,8,9,10,11 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 10);
+		}
+		TEST_METHOD(test_push_back_range)
+		{
+			dynamic_circular_buffer <std::string> a = { "a","b","c" };
+			std::list<std::string> origin = { "d","e" };
+			a.push_back(origin.begin(), origin.end());
+			std::vector<std::string> b = { "a","b","c","d","e" };
 			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
 		}
+		TEST_METHOD(test_array_one_two)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3,4 };
+			a.pop_front();
+			a.push_back(5);
+			a.pop_front();
+			a.push_back(6);
+			std::vector<int> one(a.array_one().begin(), a.array_one().end());
+			std::vector<int> two(a.array_two().begin(), a.array_two().end());
+			std::vector<int> b = { 3,4 };
+			std::vector<int> c = { 5,6 };
+			Assert::IsTrue(one == b && two == c);
+		}
+		TEST_METHOD(test_linearize)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3,4 };
+			a.pop_front();
+			a.pop_front();
+			a.push_back(5);
+			a.push_back(6);
+			std::span<int> span = a.linearize();
+			std::vector<int> b = { 3,4,5,6 };
+			Assert::IsTrue(std::equal(span.begin(), span.end(), b.begin()) && span.size() == 4);
+			Assert::IsTrue(a.array_two().empty() && std::equal(a.begin(), a.end(), b.begin()));
+		}
+		TEST_METHOD(test_full_policies)
+		{
+			dynamic_circular_buffer <int, std::allocator<int>, overwrite_oldest> a = { 1,2,3 };
+			a.push_back(4);
+			std::vector<int> b = { 2,3,4 };
+			Assert::IsTrue(a.capacity() == 3 && std::equal(a.begin(), a.end(), b.begin()));
+			std::vector<int> c = { 5,6,7,8 };
+			Assert::IsTrue(a.push_back(c.begin(), c.end()) == 3);
+			Assert::IsTrue(a.capacity() == 3 && a.front() == 6 && a.back() == 8);
+
+			dynamic_circular_buffer <int, std::allocator<int>, reject_newest> d = { 1,2,3 };
+			Assert::IsFalse(d.push_back(4));
+			d.pop_back();
+			Assert::IsTrue(d.push_back(c.begin(), c.end()) == 1);
+			std::vector<int> e = { 1,2,5 };
+			Assert::IsTrue(d.capacity() == 3 && std::equal(d.begin(), d.end(), e.begin()));
+		}
+		TEST_METHOD(test_block_when_full_bulk)
+		{
+			using blocking = dynamic_circular_buffer <int, std::allocator<int>, block_when_full>;
+			static_assert(!noexcept(std::declval<const blocking&>().size()) && noexcept(std::declval<const dynamic_circular_buffer<int>&>().size()));
+			blocking a;
+			a.reserve(4);
+			int b[] = { 1,2,3 };
+			Assert::IsTrue(a.write(b, 2) == 2);
+			Assert::IsTrue(a.push_back(b + 2, b + 3) == 1);
+			std::vector<int> c = { 1,2,3 };
+			Assert::IsTrue(a.size() == 3 && std::equal(a.begin(), a.end(), c.begin()));
+			blocking d;
+			Assert::ExpectException<std::length_error>([&d]() { d.push_back(1); });
+			Assert::ExpectException<std::length_error>([&d, &b]() { d.write(b, 2); });
+			Assert::IsTrue(d.empty());
+		}
+		TEST_METHOD(test_stats)
+		{
+			dynamic_circular_buffer <int, std::allocator<int>, grow_when_full, buffer_stats> a;
+			for (int i = 0; i < 5; ++i)
+				a.push_back(i);
+			a.pop_back();
+			buffer_stats_snapshot stats = a.stats();
+			Assert::IsTrue(stats.pushes == 5 && stats.pops == 1 && stats.high_water_mark == 5);
+			Assert::IsTrue(stats.reallocations == 4 && stats.bytes_moved == (1 + 2 + 4) * sizeof(int));
+
+			dynamic_circular_buffer <int, std::allocator<int>, overwrite_oldest, buffer_stats> b = { 1,2,3 };
+			std::vector<int> c = { 4,5 };
+			b.push_back(c.begin(), c.end());
+			b.push_back(6);
+			Assert::IsTrue(b.stats().pushes == 3 && b.stats().overwrites == 3 && b.front() == 4);
+			dynamic_circular_buffer <int, std::allocator<int>, overwrite_oldest, buffer_stats> d;
+			b.swap(d);
+			Assert::IsTrue(b.stats().pushes == 0 && d.stats().pushes == 3 && d.stats().overwrites == 3);
+		}
+		TEST_METHOD(test_mirrored_storage)
+		{
+			dynamic_circular_buffer <int, mirrored_allocator<int>> a;
+			a.reserve(1000);
+			Assert::IsTrue(a.capacity() >= 1000);
+			const int cap = static_cast<int>(a.capacity());
+			for (int i = 0; i < cap; ++i)
+				a.push_back(i);
+			for (int i = 0; i < 10; ++i)
+				a.pop_front();
+			a.push_back(cap);
+			a.push_back(cap + 1);
+			std::vector<int> b(cap - 8);
+			std::iota(b.begin(), b.end(), 10);
+			std::vector<int> c(a.array_one().begin(), a.array_one().end());
+			c.insert(c.end(), a.array_two().begin(), a.array_two().end());
+			Assert::IsTrue(c == b && std::equal(a.begin(), a.end(), b.begin()));
+#if defined(__linux__)
+			Assert::IsTrue(a.array_one().size() == b.size() && a.array_two().empty());
+#endif
+			std::span<int> span = a.linearize();
+			Assert::IsTrue(std::equal(span.begin(), span.end(), b.begin()) && span.size() == b.size());
+			a.push_back(cap + 2);
+			a.push_back(cap + 3);
+			a.push_back(cap + 4);
+			Assert::IsTrue(a.size() == b.size() + 3 && a.back() == cap + 4 && a.front() == 10);
+		}
+		TEST_METHOD(test_iterator_wrap)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3 };
+			auto it = a.begin();
+			it += 4;
+			Assert::IsTrue(*it == 2);
+			--it;
+			--it;
+			Assert::IsTrue(*it == 3);
+		}
 		TEST_METHOD(test_erase)
 		{
 			dynamic_circular_buffer <int> a = { 1,2,1 };
@@ -322,6 +705,15 @@ namespace buffertests
 			std::vector<int> b = { 1,1 };
 			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
 		}
+		TEST_METHOD(test_erase_wrapped)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3 };
+			a.pop_front();
+			a.push_back(4);
+			a.erase(a.begin() + 1);
+			std::vector<int> b = { 2,4 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 2);
+		}
 		TEST_METHOD(test_pop_back)
 		{
 			dynamic_circular_buffer <int> a = { 1,2,1 };
@@ -336,5 +728,1134 @@ namespace buffertests
 			std::vector<int> b = { 2,1 };
 			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()));
 		}
+		TEST_METHOD(test_pop_keeps_capacity)
+		{
+			dynamic_circular_buffer <std::string> a = { "a","b","c" };
+			a.pop_front();
+			a.pop_back();
+			Assert::IsTrue(a.size() == 1 && a.capacity() == 3 && a.front() == "b");
+			a.push_back("d");
+			a.push_back("e");
+			std::vector<std::string> b = { "b","d","e" };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.capacity() == 3);
+			a.pop_front();
+			a.pop_front();
+			a.pop_front();
+			Assert::IsTrue(a.empty() && a.capacity() == 3);
+		}
+		TEST_METHOD(test_erase_shorter_side)
+		{
+			dynamic_circular_buffer <std::string> a = { "a","b","c","d","e","f" };
+			a.erase(a.begin() + 1);
+			a.erase(a.begin() + 3);
+			std::vector<std::string> b = { "a","c","d","f" };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 4 && a.capacity() == 6);
+		}
+		TEST_METHOD(test_resize)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3 };
+			a.pop_front();
+			a.push_back(4);
+			a.resize(5);
+			std::vector<int> b = { 2,3,4,0,0 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 5);
+			a.resize(2);
+			Assert::IsTrue(a.size() == 2 && a.front() == 2 && a.back() == 3 && a.capacity() == 5);
+		}
+		TEST_METHOD(test_growth_keeps_order)
+		{
+			dynamic_circular_buffer <std::string> a = { "a","b","c" };
+			a.pop_front();
+			a.push_back("d");
+			a.push_back("e");
+			a.push_back("f");
+			std::vector<std::string> b = { "b","c","d","e","f" };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 5 && a.capacity() == 6);
+		}
+		TEST_METHOD(test_growth_from_empty)
+		{
+			dynamic_circular_buffer <int> a;
+			for (int i = 0; i < 100; ++i)
+				a.push_back(i);
+			std::vector<int> b(100);
+			std::iota(b.begin(), b.end(), 0);
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.size() == 100 && a.capacity() == 128);
+		}
+		TEST_METHOD(test_growth_factor)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3,4 };
+			a.set_growth_factor(1.5);
+			a.push_back(5);
+			Assert::IsTrue(a.capacity() == 6 && a.growth_factor() == 1.5);
+			Assert::ExpectException<std::invalid_argument>([&a]() { a.set_growth_factor(1.0); });
+		}
+		TEST_METHOD(test_reserve_shrink_to_fit)
+		{
+			dynamic_circular_buffer <int> a = { 1,2,3 };
+			a.reserve(10);
+			Assert::IsTrue(a.capacity() == 10 && a.size() == 3);
+			a.pop_front();
+			a.shrink_to_fit();
+			std::vector<int> b = { 2,3 };
+			Assert::IsTrue(std::equal(a.begin(), a.end(), b.begin()) && a.capacity() == 2);
+		}
+	};
+
+	TEST_CLASS(spsc_buffer)
+	{
+	public:
+		TEST_METHOD(test_push_pop)
+		{
+			spsc_circular_buffer <int, 3> a;
+			int val = 0;
+			Assert::IsTrue(a.try_push(1) && a.try_push(2));
+			Assert::IsTrue(a.try_pop(val) && val == 1);
+			Assert::IsTrue(a.try_pop(val) && val == 2);
+		}
+		TEST_METHOD(test_empty)
+		{
+			spsc_circular_buffer <int, 3> a;
+			int val = 7;
+			Assert::IsTrue(a.empty() && !a.try_pop(val) && val == 7);
+		}
+		TEST_METHOD(test_full)
+		{
+			spsc_circular_buffer <std::string, 2> a;
+			Assert::IsTrue(a.try_push("a") && a.try_push("b"));
+			Assert::IsTrue(a.full() && !a.try_push("c") && a.size() == 2);
+		}
+		TEST_METHOD(test_wraparound)
+		{
+			spsc_circular_buffer <int, 3> a;
+			std::vector<int> b;
+			int val;
+			for (int i = 0; i < 10; ++i) {
+				a.try_push(i);
+				if (i % 2 == 1) {
+					while (a.try_pop(val))
+						b.push_back(val);
+				}
+			}
+			std::vector<int> c(10);
+			std::iota(c.begin(), c.end(), 0);
+			Assert::IsTrue(b == c);
+		}
+		TEST_METHOD(test_two_threads)
+		{
+			spsc_circular_buffer <int, 64> a;
+			const int count = 100000;
+			std::thread producer([&a]() {
+				for (int i = 0; i < count; ++i)
+					while (!a.try_push(i)) {}
+			});
+			bool ordered = true;
+			int val;
+			for (int i = 0; i < count; ++i) {
+				while (!a.try_pop(val)) {}
+				ordered = ordered && (val == i);
+			}
+			producer.join();
+			Assert::IsTrue(ordered && a.empty());
+		}
+	};
+
+	TEST_CLASS(mpmc_buffer)
+	{
+	public:
+		TEST_METHOD(test_enqueue_dequeue)
+		{
+			mpmc_circular_buffer <std::string, 4> a;
+			std::string val;
+			Assert::IsTrue(a.try_enqueue("a") && a.try_enqueue("b"));
+			Assert::IsTrue(a.try_dequeue(val) && val == "a");
+			Assert::IsTrue(a.try_dequeue(val) && val == "b");
+			Assert::IsTrue(a.empty() && !a.try_dequeue(val));
+		}
+		TEST_METHOD(test_full)
+		{
+			mpmc_circular_buffer <int, 2> a;
+			Assert::IsTrue(a.try_enqueue(1) && a.try_enqueue(2) && !a.try_enqueue(3));
+			Assert::IsTrue(a.size() == 2);
+		}
+		TEST_METHOD(test_bulk)
+		{
+			mpmc_circular_buffer <int, 4> a;
+			std::vector<int> origin = { 1,2,3,4,5,6 };
+			Assert::IsTrue(a.try_enqueue_bulk(origin.begin(), origin.size()) == 4);
+			std::vector<int> b;
+			Assert::IsTrue(a.try_dequeue_bulk(std::back_inserter(b), 3) == 3);
+			Assert::IsTrue(a.try_enqueue_bulk(origin.begin() + 4, 2) == 2);
+			Assert::IsTrue(a.try_dequeue_bulk(std::back_inserter(b), 10) == 3);
+			std::vector<int> c = { 1,2,3,4,5,6 };
+			Assert::IsTrue(b == c);
+		}
+		TEST_METHOD(test_bulk_zero_count)
+		{
+			mpmc_circular_buffer <int, 8> a;
+			std::vector<int> origin = { 1,2 };
+			std::vector<int> b;
+			Assert::IsTrue(a.try_enqueue_bulk(origin.begin(), 0) == 0);
+			Assert::IsTrue(a.try_dequeue_bulk(std::back_inserter(b), 0) == 0);
+			Assert::IsTrue(a.try_enqueue_bulk(origin.begin(), 2) == 2);
+			Assert::IsTrue(a.try_dequeue_bulk(std::back_inserter(b), 0) == 0);
+			Assert::IsTrue(b.empty() && a.size() == 2);
+		}
+		struct counted {
+			static inline int copies = 0;
+			counted() = default;
+			counted(const counted&) { ++copies; }
+			counted(counted&&) noexcept {}
+			counted& operator =(counted&&) noexcept { return *this; }
+		};
+		TEST_METHOD(test_full_skips_construction)
+		{
+			mpmc_circular_buffer <counted, 2> a;
+			const counted item;
+			std::vector<counted> items(3);
+			counted::copies = 0;
+			Assert::IsTrue(a.try_enqueue(item) && a.try_enqueue(item));
+			Assert::IsTrue(counted::copies == 2);
+			Assert::IsFalse(a.try_enqueue(item));
+			Assert::IsTrue(a.try_enqueue_bulk(items.begin(), items.size()) == 0);
+			Assert::IsTrue(counted::copies == 2);
+		}
+		TEST_METHOD(test_many_threads)
+		{
+			mpmc_circular_buffer <int, 16> a;
+			const int threads = 4;
+			const int count = 20000;
+			std::atomic<long long> sum = 0;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t) {
+				workers.emplace_back([&a]() {
+					for (int i = 1; i <= count; ++i)
+						while (!a.try_enqueue(i))
+							std::this_thread::yield();
+				});
+				workers.emplace_back([&a, &sum]() {
+					int val;
+					for (int i = 0; i < count; ++i) {
+						while (!a.try_dequeue(val))
+							std::this_thread::yield();
+						sum += val;
+					}
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+			Assert::IsTrue(sum == static_cast<long long>(threads) * count * (count + 1) / 2 && a.empty());
+		}
+	};
+
+	TEST_CLASS(blocking_queue)
+	{
+	public:
+		TEST_METHOD(test_push_pop)
+		{
+			blocking_circular_queue <std::string, 4> a;
+			a.push("a");
+			a.push("b");
+			Assert::IsTrue(a.size() == 2 && a.pop() == "a");
+			std::string val;
+			Assert::IsTrue(a.try_pop(val) && val == "b");
+			Assert::IsFalse(a.try_pop(val));
+		}
+		TEST_METHOD(test_pop_for)
+		{
+			blocking_circular_queue <int, 4> a;
+			int val = 0;
+			Assert::IsFalse(a.pop_for(val, std::chrono::milliseconds(5)));
+			a.push(3);
+			Assert::IsTrue(a.pop_for(val, std::chrono::milliseconds(5)) && val == 3);
+		}
+		TEST_METHOD(test_pop_batch)
+		{
+			blocking_circular_queue <int, 8> a;
+			for (int i = 0; i < 5; ++i)
+				a.push(i);
+			std::vector<int> b;
+			Assert::IsTrue(a.pop_batch(std::back_inserter(b), 3) == 3);
+			Assert::IsTrue(a.pop_batch(std::back_inserter(b), 8) == 2);
+			std::vector<int> c = { 0,1,2,3,4 };
+			Assert::IsTrue(b == c && a.empty());
+			Assert::ExpectException<std::invalid_argument>([]() { blocking_circular_queue <int, 8> d(0); });
+		}
+		TEST_METHOD(test_producers_consumers)
+		{
+			blocking_circular_queue <int, 8> a(4);
+			const int threads = 3;
+			const int count = 20000;
+			std::atomic<long long> sum = 0;
+			std::vector<std::thread> workers;
+			for (int t = 0; t < threads; ++t) {
+				workers.emplace_back([&a]() {
+					for (int i = 1; i <= count; ++i)
+						a.push(i);
+				});
+				workers.emplace_back([&a, &sum]() {
+					std::vector<int> batch;
+					for (int taken = 0; taken < count; ) {
+						batch.clear();
+						taken += static_cast<int>(a.pop_batch(std::back_inserter(batch), count - taken));
+						sum += std::accumulate(batch.begin(), batch.end(), 0LL);
+					}
+				});
+			}
+			for (auto& worker : workers)
+				worker.join();
+			Assert::IsTrue(sum == static_cast<long long>(threads) * count * (count + 1) / 2 && a.empty());
+		}
+		TEST_METHOD(test_batched_wakeups)
+		{
+			blocking_circular_queue <int, 64> a(8, std::chrono::seconds(10));
+			size_t taken = 0;
+			std::thread consumer([&]() {
+				std::vector<int> batch;
+				taken = a.pop_batch(std::back_inserter(batch), 64);
+			});
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			for (int i = 0; i < 8; ++i) {
+				a.push(i);
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+			consumer.join();
+			// one wake for the first element and one for the full batch
+			Assert::IsTrue(taken == 8 && a.consumer_wakeups() <= 2);
+
+			blocking_circular_queue <int, 64> b;
+			std::thread unbatched([&]() {
+				std::vector<int> batch;
+				for (size_t n = 0; n < 8; )
+					n += b.pop_batch(std::back_inserter(batch), 64);
+			});
+			for (int i = 0; i < 8; ++i) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				b.push(i);
+			}
+			unbatched.join();
+			Assert::IsTrue(b.consumer_wakeups() > 2);
+		}
+		TEST_METHOD(test_linger_bounds_latency)
+		{
+			blocking_circular_queue <int, 64> a(8, std::chrono::milliseconds(20));
+			a.push(1);
+			a.push(2);
+			std::vector<int> b;
+			const auto start = std::chrono::steady_clock::now();
+			Assert::IsTrue(a.pop_batch(std::back_inserter(b), 64) == 2);
+			const auto waited = std::chrono::steady_clock::now() - start;
+			Assert::IsTrue(waited >= std::chrono::milliseconds(20) && waited < std::chrono::seconds(5));
+			int val = 0;
+			a.push(3);
+			Assert::IsTrue(a.try_pop(val) && val == 3);
+		}
+		TEST_METHOD(test_single_pops_never_strand_elements)
+		{
+			// each consumer takes one element and leaves, so one left asleep next to an
+			// element is only woken by the pushes that end the round
+			const int consumers = 4;
+			int stalls = 0;
+			for (int round = 0; round < 1000 && stalls == 0; ++round) {
+				blocking_circular_queue <int, 8> a;
+				std::atomic<int> consumed = 0;
+				std::vector<std::thread> workers;
+				for (int t = 0; t < consumers; ++t) {
+					workers.emplace_back([&]() {
+						a.pop();
+						++consumed;
+					});
+				}
+				for (int i = 0; i < consumers; ++i) {
+					a.push(i);
+					if (i % 2 == round % 2)
+						std::this_thread::yield();
+				}
+				// no further push comes until every consumer got its element
+				const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+				while (consumed.load() != consumers && std::chrono::steady_clock::now() < give_up)
+					std::this_thread::yield();
+				if (consumed.load() != consumers) {
+					++stalls;
+					for (int t = 0; t < consumers; ++t)
+						a.push(-1);
+				}
+				for (auto& worker : workers)
+					worker.join();
+			}
+			Assert::AreEqual(0, stalls);
+		}
+	};
+
+	TEST_CLASS(coroutine_channel)
+	{
+	public:
+		TEST_METHOD(test_suspends_when_full)
+		{
+			single_thread_executor executor;
+			async_channel<std::string> channel(executor, 2);
+			std::vector<std::string> log;
+			produce(channel, 4, log);
+			Assert::IsTrue(channel.size() == 2 && log.size() == 2);
+			consume(channel, 4, log);
+			executor.run();
+			std::vector<std::string> b = { "pushed 0","pushed 1","popped 0","popped 1","popped 2","pushed 2","pushed 3","popped 3" };
+			Assert::IsTrue(log == b && channel.empty() && executor.empty());
+		}
+		TEST_METHOD(test_waiters_resume_in_order)
+		{
+			single_thread_executor executor;
+			async_channel<std::string> channel(executor, 0);
+			std::vector<std::string> first;
+			std::vector<std::string> second;
+			consume(channel, 2, first);
+			consume(channel, 1, second);
+			produce(channel, 3, first);
+			executor.run();
+			std::vector<std::string> b = { "pushed 0","pushed 1","popped 0","popped 2","pushed 2" };
+			Assert::IsTrue(first == b && second.size() == 1 && second[0] == "popped 1");
+		}
+	};
+
+	TEST_CLASS(soa_buffer)
+	{
+	public:
+		TEST_METHOD(test_columns)
+		{
+			soa_circular_buffer <std::tuple<long long, double, int>, 4> a;
+			for (int i = 0; i < 6; ++i)
+				a.push_back(i, i * 0.5, i * 10);
+			Assert::IsTrue(a.full() && a.get<0>(0) == 2 && a.get<2>(3) == 50);
+			std::span<double> one = a.array_one<1>();
+			std::span<double> two = a.array_two<1>();
+			Assert::IsTrue(one.size() == 2 && two.size() == 2 && one[0] == 1.0 && two[1] == 2.5);
+			const soa_circular_buffer <std::tuple<long long, double, int>, 4>& b = a;
+			long long sum = std::accumulate(b.array_one<0>().begin(), b.array_one<0>().end(), 0LL);
+			sum = std::accumulate(b.array_two<0>().begin(), b.array_two<0>().end(), sum);
+			Assert::IsTrue(sum == 2 + 3 + 4 + 5);
+		}
+		TEST_METHOD(test_row_iterator)
+		{
+			soa_circular_buffer <std::tuple<int, std::string>, 3> a;
+			a.push_back(std::make_tuple(1, std::string("a")));
+			a.push_back(2, "b");
+			a.push_back(3, "c");
+			a.push_back(4, "d");
+			std::vector<int> keys;
+			for (auto [key, name] : a) {
+				keys.push_back(key);
+				name += "!";
+			}
+			std::vector<int> b = { 2,3,4 };
+			Assert::IsTrue(keys == b && std::get<1>(a[0]) == "b!" && std::get<1>(a.back()) == "d!");
+			auto it = a.begin();
+			it += 2;
+			Assert::IsTrue(std::get<0>(*it) == 4 && it - a.begin() == 2 && std::get<0>(a.begin()[1]) == 3);
+			soa_circular_buffer <std::tuple<int, std::string>, 3>::const_iterator c_it = it;
+			Assert::IsTrue(std::get<1>(*c_it) == "d!");
+		}
+		TEST_METHOD(test_pop_and_copy)
+		{
+			soa_circular_buffer <std::tuple<int, std::string>, 3> a;
+			a.push_back(1, "a");
+			a.push_back(2, "b");
+			a.pop_front();
+			a.push_back(3, "c");
+			a.push_back(4, "d");
+			a.pop_back();
+			soa_circular_buffer <std::tuple<int, std::string>, 3> b = a;
+			Assert::IsTrue(b.size() == 2 && std::get<0>(b.front()) == 2 && std::get<1>(b[1]) == "c");
+			soa_circular_buffer <std::tuple<int, std::string>, 3> c = std::move(b);
+			Assert::IsTrue(c.size() == 2 && b.empty() && std::get<1>(c.at(0)) == "b");
+			Assert::ExpectException<std::out_of_range>([&c]() { c.at(2); });
+			c.clear();
+			Assert::IsTrue(c.empty() && c.array_one<0>().empty());
+		}
+		TEST_METHOD(test_overwrite_from_oldest_row)
+		{
+			soa_circular_buffer <std::tuple<int, std::string>, 2> a;
+			a.push_back(1, "a");
+			a.push_back(2, "b");
+			const soa_circular_buffer <std::tuple<int, std::string>, 2>& b = a;
+			Assert::IsTrue(std::get<0>(b.front()) == 1 && std::get<1>(b.back()) == "b");
+			// the arguments refer to the row that gets overwritten
+			a.emplace_back(std::get<0>(a.front()) + 2, std::get<1>(a.front()) + std::get<1>(a.front()));
+			Assert::IsTrue(std::get<0>(b.back()) == 3 && std::get<1>(b.back()) == "aa" && std::get<0>(b.front()) == 2);
+			soa_circular_buffer <std::tuple<int, int>, 1> c;
+			c.push_back(1, 2);
+			c.emplace_back(std::get<1>(c.front()), std::get<0>(c.front()));
+			Assert::IsTrue(std::get<0>(c.front()) == 2 && std::get<1>(c.front()) == 1);
+		}
+		TEST_METHOD(test_reuse_moved_from)
+		{
+			soa_circular_buffer <std::tuple<int, std::string>, 2> a;
+			a.push_back(1, "a");
+			soa_circular_buffer <std::tuple<int, std::string>, 2> b = std::move(a);
+			a.push_back(2, "b");
+			a.push_back(3, "c");
+			a.push_back(4, "d");
+			Assert::IsTrue(a.size() == 2 && std::get<0>(a.front()) == 3 && std::get<1>(a.back()) == "d");
+			soa_circular_buffer <std::tuple<int, std::string>, 2> c;
+			c = std::move(b);
+			b.push_back(5, "e");
+			Assert::IsTrue(b.size() == 1 && std::get<1>(b.front()) == "e" && std::get<1>(c.front()) == "a");
+			soa_circular_buffer <std::tuple<int, std::string>, 2> d = std::move(b);
+			b = d;
+			Assert::IsTrue(b.size() == 1 && std::get<0>(b.front()) == 5);
+		}
+	};
+
+	TEST_CLASS(inline_buffer)
+	{
+	public:
+		static constexpr int constexpr_sum()
+		{
+			circular_buffer <int, 4, inline_storage> a = { 1,2,3 };
+			a.push_back(4);
+			a.push_back(5);
+			a.pop_front();
+			int sum = 0;
+			for (int val : a)
+				sum += val;
+			return sum;
+		}
+		TEST_METHOD(test_constexpr)
+		{
+			static_assert(constexpr_sum() == 12);
+			constexpr circular_buffer <int, 3, inline_storage> a = { 1,2 };
+			static_assert(a.size() == 2 && a.back() == 2 && !a.full());
+			Assert::IsTrue(constexpr_sum() == 12);
+		}
+		TEST_METHOD(test_push_and_overwrite)
+		{
+			circular_buffer <std::string, 3, inline_storage> a;
+			Assert::IsTrue(a.empty() && a.capacity() == 3);
+			for (int i = 0; i != 5; ++i)
+				Assert::IsTrue(a.push_back(std::to_string(i)));
+			Assert::IsTrue(a.full() && a.front() == "2" && a[1] == "3" && a.back() == "4");
+			Assert::IsTrue(a.array_one().size() == 1 && a.array_two().size() == 2 && a.array_two()[0] == "3");
+			std::vector<std::string> b(a.begin(), a.end());
+			std::vector<std::string> c = { "2","3","4" };
+			Assert::IsTrue(b == c);
+			a.pop_back();
+			a.pop_front();
+			Assert::IsTrue(a.size() == 1 && a.at(0) == "3");
+			Assert::ExpectException<std::out_of_range>([&a]() { a.at(1); });
+		}
+		TEST_METHOD(test_copy_and_move)
+		{
+			circular_buffer <std::string, 3, inline_storage> a = { "a","b","c" };
+			a.push_back("d");
+			circular_buffer <std::string, 3, inline_storage> b = a;
+			circular_buffer <std::string, 3, inline_storage> c = std::move(a);
+			Assert::IsTrue(a.empty() && b.size() == 3 && c.front() == "b" && c.back() == "d");
+			circular_buffer <std::string, 3, inline_storage> d = { "x" };
+			d.swap(b);
+			Assert::IsTrue(d.size() == 3 && b.size() == 1 && b.front() == "x");
+			Assert::ExpectException<std::range_error>([]() { circular_buffer <int, 2, inline_storage> e = { 1,2,3 }; });
+		}
+		TEST_METHOD(test_inline_alias)
+		{
+			static_assert(std::is_same_v<inline_circular_buffer<int, 8>, circular_buffer<int, 8, inline_storage>>);
+			static_assert(sizeof(inline_circular_buffer<char, 16>) <= 16 + 2 * sizeof(size_t));
+			inline_circular_buffer<int, 1024> a;
+			a.push_back(1);
+			Assert::IsTrue(a.front() == 1 && a.capacity() == 1024);
+		}
+	};
+
+	TEST_CLASS(segmented_algorithms)
+	{
+	public:
+		TEST_METHOD(test_copy)
+		{
+			circular_buffer <int, 5> a = { 1,2,3,4,5 };
+			a.push_back(6);
+			a.push_back(7);
+			std::vector<int> b(5);
+			Assert::IsTrue(copy(a.begin(), a.end(), b.begin()) == b.end());
+			std::vector<int> c = { 3,4,5,6,7 };
+			Assert::IsTrue(b == c);
+			int d[] = { 10,20,30 };
+			auto it = a.begin();
+			it += 1;
+			auto end = copy(d, d + 3, it);
+			Assert::IsTrue(end - a.begin() == 4 && a[1] == 10 && a[2] == 20 && a[3] == 30 && a[4] == 7);
+			dynamic_circular_buffer <int> e = { 0,0,0,0 };
+			e.pop_front();
+			e.push_back(0);
+			auto a_last = a.cbegin();
+			a_last += 4;
+			auto e_end = copy(a.cbegin(), a_last, e.begin());
+			Assert::IsTrue(e_end == e.end() && e[0] == 3 && e[1] == 10 && e[3] == 30);
+		}
+		TEST_METHOD(test_fill_and_find)
+		{
+			circular_buffer <char, 6> a = { 'a','b','c','d','e','f' };
+			a.push_back('g');
+			a.push_back('h');
+			Assert::IsTrue(find(a.begin(), a.end(), 'd') - a.begin() == 1);
+			Assert::IsTrue(find(a.begin(), a.end(), 'h') - a.begin() == 5);
+			Assert::IsTrue(find(a.cbegin(), a.cend(), 'a') == a.cend());
+			auto it = a.begin();
+			it += 2;
+			fill(it, a.end(), 'x');
+			Assert::IsTrue(a[0] == 'c' && a[1] == 'd' && a[2] == 'x' && a[5] == 'x');
+			Assert::IsTrue(find(a.begin(), a.end(), 'x') == it);
+		}
+		TEST_METHOD(test_equal_and_accumulate)
+		{
+			circular_buffer <int, 4> a = { 1,2,3,4 };
+			a.push_back(5);
+			dynamic_circular_buffer <int> b = { 0,0,2,3 };
+			b.pop_front();
+			b.pop_front();
+			b.push_back(4);
+			b.push_back(5);
+			std::vector<int> c = { 2,3,4,5 };
+			Assert::IsTrue(equal(a.begin(), a.end(), c.begin()));
+			Assert::IsTrue(equal(a.begin(), a.end(), b.begin()));
+			Assert::IsTrue(equal(a.cbegin(), a.cend(), c.begin(), c.end()));
+			c.push_back(6);
+			Assert::IsFalse(equal(a.cbegin(), a.cend(), c.begin(), c.end()));
+			b.back() = 6;
+			Assert::IsFalse(equal(a.begin(), a.end(), b.begin()));
+			Assert::IsTrue(accumulate(a.begin(), a.end(), 0) == 14);
+			Assert::IsTrue(accumulate(a.cbegin(), a.cend(), 1, [](int x, int y) { return x * y; }) == 120);
+			circular_buffer <std::string, 2> d = { "a","b" };
+			d.push_back("c");
+			Assert::IsTrue(accumulate(d.begin(), d.end(), std::string()) == "bc");
+		}
+		TEST_METHOD(test_equal_single_pass)
+		{
+			circular_buffer <int, 4> a = { 1,2,3,4 };
+			a.push_back(5);
+			std::istringstream one("2 3 4 5");
+			Assert::IsTrue(equal(a.begin(), a.end(), std::istream_iterator<int>(one)));
+			std::istringstream two("2 3 4 5");
+			Assert::IsTrue(equal(a.begin(), a.end(), std::istream_iterator<int>(two), std::istream_iterator<int>()));
+			std::istringstream three("2 3 4 5 6");
+			Assert::IsFalse(equal(a.begin(), a.end(), std::istream_iterator<int>(three), std::istream_iterator<int>()));
+			std::istringstream four("2 3 4");
+			Assert::IsFalse(equal(a.begin(), a.end(), std::istream_iterator<int>(four), std::istream_iterator<int>()));
+			std::istringstream five("2 3 9 5");
+			Assert::IsFalse(equal(a.cbegin(), a.cend(), std::istream_iterator<int>(five), std::istream_iterator<int>()));
+		}
+	};
+
+	TEST_CLASS(simd_reductions)
+	{
+	public:
+		template <class T>
+		static void check_reductions(size_t pushes)
+		{
+			circular_buffer <T, 100> a;
+			dynamic_circular_buffer <T> b;
+			for (size_t i = 0; i != pushes; ++i) {
+				a.push_back(T((i * 7) % 23) - T(5));
+				b.push_back(T(i % 3));
+			}
+			while (b.size() > a.size())
+				b.pop_front();
+			std::vector<T> c(a.begin(), a.end());
+			T dot = T();
+			for (size_t i = 0; i != a.size(); ++i)
+				dot += a[i] * b[i];
+			for (simd_level level : { simd_level::scalar, simd_level::sse2, simd_level::avx2, simd_level::avx512 }) {
+				Assert::IsTrue(window_sum(a, level) == std::accumulate(c.begin(), c.end(), T()));
+				Assert::IsTrue(window_min(a, level) == *std::min_element(c.begin(), c.end()));
+				Assert::IsTrue(window_max(a, level) == *std::max_element(c.begin(), c.end()));
+				Assert::IsTrue(window_dot(a, b, level) == dot);
+			}
+		}
+		TEST_METHOD(test_arithmetic_types)
+		{
+			for (size_t pushes : { 1, 37, 100, 173 }) {
+				check_reductions<int>(pushes);
+				check_reductions<double>(pushes);
+				check_reductions<float>(pushes);
+				check_reductions<int8_t>(pushes);
+				check_reductions<uint16_t>(pushes);
+				check_reductions<int64_t>(pushes);
+				check_reductions<long double>(pushes);
+			}
+		}
+		TEST_METHOD(test_empty)
+		{
+			circular_buffer <double, 8> a;
+			Assert::IsTrue(window_sum(a) == 0.0);
+			Assert::ExpectException<std::out_of_range>([&a]() { window_min(a); });
+			Assert::ExpectException<std::out_of_range>([&a]() { window_max(a); });
+			circular_buffer <double, 8> b = { 1.0 };
+			Assert::ExpectException<std::invalid_argument>([&a, &b]() { window_dot(a, b); });
+		}
+	};
+
+	TEST_CLASS(sliding_window_stats)
+	{
+	public:
+		TEST_METHOD(test_matches_rescan)
+		{
+			window_stats <double, 50> a;
+			for (int i = 0; i != 1000; ++i) {
+				a.push(1e6 + (i * 37) % 101 * 0.25);
+				if (i % 97 != 0)
+					continue;
+				const std::vector<double> b(a.buffer().cbegin(), a.buffer().cend());
+				const double mean = std::accumulate(b.begin(), b.end(), 0.0) / b.size();
+				double m2 = 0;
+				for (double x : b)
+					m2 += (x - mean) * (x - mean);
+				Assert::IsTrue(std::abs(a.sum() - mean * b.size()) < 1e-3 && std::abs(a.mean() - mean) < 1e-6);
+				Assert::IsTrue(std::abs(a.variance() - m2 / b.size()) < 1e-6);
+				if (b.size() > 1)
+					Assert::IsTrue(std::abs(a.sample_variance() - m2 / (b.size() - 1)) < 1e-6);
+			}
+			Assert::IsTrue(a.full() && a.size() == 50);
+		}
+		TEST_METHOD(test_ewma_and_clear)
+		{
+			window_stats <int, 4> a(0.5);
+			a.push(8);
+			Assert::IsTrue(a.ewma() == 8.0 && a.variance() == 0.0 && a.sample_variance() == 0.0);
+			a.push(4);
+			a.push(0);
+			Assert::IsTrue(a.ewma() == 3.0 && a.mean() == 4.0 && a.sum() == 12.0);
+			for (int i = 0; i != 4; ++i)
+				a.push(5);
+			Assert::IsTrue(a.mean() == 5.0 && a.variance() == 0.0 && a.stddev() == 0.0);
+			a.clear();
+			Assert::IsTrue(a.empty() && a.sum() == 0.0);
+			a.push(2);
+			Assert::IsTrue(a.ewma() == 2.0 && a.mean() == 2.0);
+			Assert::ExpectException<std::invalid_argument>([]() { window_stats <int, 4> b(0.0); });
+			Assert::ExpectException<std::invalid_argument>([]() { window_stats <int, 4> b(1.5); });
+		}
+	};
+
+	TEST_CLASS(sliding_window_extrema)
+	{
+	public:
+		TEST_METHOD(test_matches_rescan)
+		{
+			window_extrema <int, 7> a;
+			for (int i = 0; i != 500; ++i) {
+				a.push((i * 31) % 17 - (i % 5 == 0 ? 3 : 0));
+				const std::vector<int> b(a.buffer().cbegin(), a.buffer().cend());
+				Assert::IsTrue(a.window_min() == *std::min_element(b.begin(), b.end()));
+				Assert::IsTrue(a.window_max() == *std::max_element(b.begin(), b.end()));
+			}
+			Assert::IsTrue(a.full() && a.size() == 7);
+		}
+		TEST_METHOD(test_monotonic_and_ties)
+		{
+			window_extrema <double, 3> a;
+			Assert::ExpectException<std::out_of_range>([&a]() { a.window_min(); });
+			for (double x : { 1.0, 2.0, 3.0, 4.0 })
+				a.push(x);
+			Assert::IsTrue(a.window_min() == 2.0 && a.window_max() == 4.0);
+			for (double x : { 5.0, 5.0, 1.0 })
+				a.push(x);
+			Assert::IsTrue(a.window_min() == 1.0 && a.window_max() == 5.0);
+			a.push(0.0);
+			Assert::IsTrue(a.window_min() == 0.0 && a.window_max() == 5.0);
+			a.push(0.5);
+			Assert::IsTrue(a.window_min() == 0.0 && a.window_max() == 1.0);
+			a.clear();
+			a.push(-1.0);
+			Assert::IsTrue(a.window_min() == -1.0 && a.window_max() == -1.0);
+		}
+		TEST_METHOD(test_compare)
+		{
+			window_extrema <std::string, 2, std::greater<std::string>> a;
+			a.push("b");
+			a.push("a");
+			a.push("c");
+			Assert::IsTrue(a.window_min() == "c" && a.window_max() == "a");
+		}
+	};
+
+	TEST_CLASS(time_series)
+	{
+	public:
+		static std::vector<int> values(time_series_buffer<int, int, overwrite_oldest>::range_type range)
+		{
+			std::vector<int> result;
+			for (const auto& event : range.first)
+				result.push_back(event.second);
+			for (const auto& event : range.second)
+				result.push_back(event.second);
+			return result;
+		}
+		TEST_METHOD(test_search_wrapped)
+		{
+			time_series_buffer <int, int, overwrite_oldest> a(6);
+			for (int i = 0; i != 10; ++i)
+				a.push(i * 10, i);
+			Assert::IsTrue(a.size() == 6 && a.front().first == 40 && !a.buffer().array_two().empty());
+			for (int t = 30; t != 110; t += 5) {
+				const auto lower = std::partition_point(a.cbegin(), a.cend(), [t](const auto& event) { return event.first < t; });
+				const auto upper = std::partition_point(a.cbegin(), a.cend(), [t](const auto& event) { return event.first <= t; });
+				Assert::IsTrue(a.lower_bound(t) == lower && a.upper_bound(t) == upper);
+			}
+			std::vector<int> b = { 5,6,7 };
+			Assert::IsTrue(values(a.range(45, 80)) == b);
+			std::vector<int> c = { 8,9 };
+			Assert::IsTrue(values(a.range(80, 1000)) == c && values(a.range(0, 40)).empty() && values(a.range(80, 50)).empty());
+			auto range = a.range(50, 90);
+			Assert::IsTrue(range.first.size() + range.second.size() == 4);
+		}
+		TEST_METHOD(test_duplicates_and_order)
+		{
+			time_series_buffer <int, std::string> a;
+			a.push(1, "a");
+			a.push(2, "b");
+			a.push(2, "c");
+			a.emplace(3, 2, 'd');
+			Assert::IsTrue(a.lower_bound(2) - a.cbegin() == 1 && a.upper_bound(2) - a.cbegin() == 3);
+			Assert::IsTrue(a.back().second == "dd");
+			Assert::ExpectException<std::invalid_argument>([&a]() { a.push(2, "e"); });
+			a.erase_before(2);
+			Assert::IsTrue(a.size() == 3 && a.front().second == "b");
+			a.erase_before(10);
+			Assert::IsTrue(a.empty() && a.lower_bound(0) == a.cend());
+		}
+	};
+
+	TEST_CLASS(iterator_conformance)
+	{
+	public:
+		static_assert(std::random_access_iterator<circular_buffer<int, 8>::iterator>);
+		static_assert(std::random_access_iterator<circular_buffer<int, 8>::const_iterator>);
+		static_assert(std::random_access_iterator<circular_buffer<int, 7>::iterator>);
+		static_assert(std::random_access_iterator<dynamic_circular_buffer<int>::iterator>);
+		static_assert(std::random_access_iterator<dynamic_circular_buffer<int>::const_iterator>);
+		static_assert(std::ranges::random_access_range<circular_buffer<int, 8>>);
+		static_assert(std::ranges::random_access_range<const dynamic_circular_buffer<int>>);
+		static_assert(std::ranges::sized_range<circular_buffer<int, 8>>);
+
+		TEST_METHOD(test_arithmetic)
+		{
+			circular_buffer <int, 5> a = { 1,2,3,4,5 };
+			a.push_back(6);
+			a.push_back(7);
+			const auto it = a.begin() + 2;
+			Assert::IsTrue(*it == 5 && *(2 + a.begin()) == 5 && *(a.end() - 1) == 7 && a.begin()[4] == 7);
+			Assert::IsTrue(it[-2] == 3 && (it - 1)[0] == 4);
+			circular_buffer <int, 5>::const_iterator c_it;
+			c_it = it;
+			Assert::IsTrue(c_it == a.cbegin() + 2 && c_it > a.cbegin());
+			dynamic_circular_buffer <int> b = { 1,2,3 };
+			dynamic_circular_buffer <int>::const_iterator d_it;
+			d_it = std::as_const(b).begin() + 1;
+			Assert::IsTrue(*d_it == 2 && d_it[1] == 3);
+		}
+		TEST_METHOD(test_sort_wrapped)
+		{
+			circular_buffer <int, 100> a;
+			for (int i = 0; i != 150; ++i)
+				a.push_back((i * 37) % 101);
+			std::vector<int> b(a.begin(), a.end());
+			std::sort(b.begin(), b.end());
+			circular_buffer <int, 100> c = a;
+			std::sort(c.begin(), c.end());
+			Assert::IsTrue(std::equal(b.begin(), b.end(), c.cbegin()));
+			circular_buffer <int, 100> d = a;
+			std::nth_element(d.begin(), d.begin() + 50, d.end());
+			Assert::IsTrue(d[50] == b[50]);
+			std::sort(std::execution::par, a.begin(), a.end());
+			Assert::IsTrue(std::equal(b.begin(), b.end(), a.cbegin()));
+		}
+		TEST_METHOD(test_ranges)
+		{
+			dynamic_circular_buffer <int> a = { 5,1,4 };
+			a.pop_front();
+			a.push_back(2);
+			a.push_back(3);
+			std::ranges::sort(a);
+			std::vector<int> b = { 1,2,3,4 };
+			Assert::IsTrue(std::ranges::equal(a, b));
+			auto view = std::views::all(a) | std::views::reverse | std::views::take(2);
+			std::vector<int> c(view.begin(), view.end());
+			std::vector<int> d = { 4,3 };
+			Assert::IsTrue(c == d && std::ranges::size(a) == 4);
+		}
+	};
+
+	TEST_CLASS(broadcast_buffer)
+	{
+	public:
+		TEST_METHOD(test_every_consumer_reads_all)
+		{
+			broadcast_circular_buffer <std::string, 4, reject_newest> a(2);
+			Assert::IsTrue(a.publish("a") && a.publish("b") && a.publish(3, 'c') && a.publish("d"));
+			Assert::IsFalse(a.publish("e"));
+			std::string val;
+			Assert::IsTrue(a.try_read(0, val) && val == "a" && a.available(0) == 3 && a.available(1) == 4);
+			Assert::IsFalse(a.publish("e"));
+			Assert::IsTrue(a.try_read(1, val) && val == "a" && a.publish("e"));
+			std::vector<std::string> b(4);
+			Assert::IsTrue(a.read_batch(0, b.begin(), 10) == 4 && b[1] == "ccc" && b[3] == "e");
+			auto range = a.peek(1);
+			Assert::IsTrue(range.first.size() == 3 && range.second.size() == 1 && range.second[0] == "e");
+			a.consume(1, 4);
+			Assert::IsTrue(a.available(0) == 0 && a.available(1) == 0 && !a.try_read(1, val));
+			Assert::ExpectException<std::invalid_argument>([]() { broadcast_circular_buffer <int, 4> c(0); });
+		}
+		TEST_METHOD(test_lapped_consumer)
+		{
+			broadcast_circular_buffer <int, 4, overwrite_oldest> a(2);
+			for (int i = 0; i != 10; ++i)
+				Assert::IsTrue(a.publish(i));
+			int b[10];
+			Assert::IsTrue(a.read_batch(0, b, 10) == 4 && b[0] == 6 && b[3] == 9 && a.lapped(0) == 6);
+			a.publish(10);
+			int val;
+			Assert::IsTrue(a.try_read(0, val) && val == 10 && a.lapped(0) == 6);
+			Assert::IsTrue(a.available(1) == 4 && a.try_read(1, val) && val == 7 && a.lapped(1) == 7);
+		}
+		TEST_METHOD(test_threads_gated)
+		{
+			broadcast_circular_buffer <int, 64> a(3);
+			const int count = 50000;
+			std::vector<std::thread> consumers;
+			std::vector<int> ordered(3, 1);
+			for (size_t c = 0; c != 3; ++c) {
+				consumers.emplace_back([&a, &ordered, c]() {
+					int next = 0;
+					int batch[16];
+					while (next != count) {
+						const size_t n = a.read_batch(c, batch, 16);
+						if (n == 0)
+							std::this_thread::yield();
+						for (size_t i = 0; i != n; ++i)
+							ordered[c] = ordered[c] && batch[i] == next++;
+					}
+				});
+			}
+			for (int i = 0; i != count; ++i)
+				a.publish(i);
+			for (std::thread& consumer : consumers)
+				consumer.join();
+			Assert::IsTrue(ordered[0] && ordered[1] && ordered[2] && a.published() == count);
+		}
+		TEST_METHOD(test_threads_lapping)
+		{
+			struct message { int64_t seq; int64_t check; };
+			broadcast_circular_buffer <message, 16, overwrite_oldest> a(2);
+			const int64_t count = 200000;
+			std::atomic<bool> done = false;
+			std::vector<int64_t> seen(2, 0);
+			std::vector<int> valid(2, 1);
+			std::vector<std::thread> consumers;
+			for (size_t c = 0; c != 2; ++c) {
+				consumers.emplace_back([&, c]() {
+					int64_t last = -1;
+					message m;
+					for (;;) {
+						const bool finished = done.load();
+						while (a.try_read(c, m)) {
+							valid[c] = valid[c] && m.seq > last && m.check == ~m.seq;
+							last = m.seq;
+							++seen[c];
+						}
+						if (finished)
+							break;
+						std::this_thread::yield();
+					}
+				});
+			}
+			for (int64_t i = 0; i != count; ++i)
+				a.publish(message{ i, ~i });
+			done = true;
+			for (std::thread& consumer : consumers)
+				consumer.join();
+			for (size_t c = 0; c != 2; ++c)
+				Assert::IsTrue(valid[c] && seen[c] + int64_t(a.lapped(c)) == count);
+		}
+	};
+
+	TEST_CLASS(sequence_numbers)
+	{
+	public:
+		TEST_METHOD(numbers_follow_pushes)
+		{
+			circular_buffer<int, 4> buf;
+			Assert::AreEqual(uint64_t(0), buf.oldest_seq());
+			Assert::AreEqual(uint64_t(0), buf.next_seq());
+			for (int i = 0; i < 6; ++i)
+				buf.push_back(i * 10);
+			Assert::AreEqual(uint64_t(2), buf.oldest_seq());
+			Assert::AreEqual(uint64_t(5), buf.newest_seq());
+			Assert::AreEqual(20, buf.at_seq(2));
+			Assert::AreEqual(50, buf.at_seq(5));
+			buf.at_seq(3) = 31;
+			Assert::AreEqual(31, buf[1]);
+			auto overwritten = [&] { buf.at_seq(1); };
+			Assert::ExpectException<std::out_of_range>(overwritten);
+			auto future = [&] { buf.at_seq(6); };
+			Assert::ExpectException<std::out_of_range>(future);
+		}
+		TEST_METHOD(numbers_survive_pops_and_clear)
+		{
+			circular_buffer<int, 4> buf;
+			int data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+			buf.write(data, 9);
+			Assert::AreEqual(uint64_t(5), buf.oldest_seq());
+			Assert::AreEqual(5, buf.at_seq(5));
+			buf.pop_front();
+			Assert::AreEqual(uint64_t(6), buf.oldest_seq());
+			buf.pop_back();
+			buf.push_back(80);
+			Assert::AreEqual(80, buf.at_seq(8));
+			buf.clear();
+			Assert::AreEqual(uint64_t(9), buf.oldest_seq());
+			Assert::AreEqual(uint64_t(8), buf.newest_seq());
+			buf.push_back(90);
+			Assert::AreEqual(90, buf.at_seq(9));
+			circular_buffer<int, 4> copy(buf);
+			Assert::AreEqual(90, copy.at_seq(9));
+			circular_buffer<int, 4, std::allocator<int>, reject_newest> rejecting;
+			rejecting.write(data, 9);
+			Assert::AreEqual(uint64_t(4), rejecting.next_seq());
+		}
+		TEST_METHOD(read_from_resumes_and_reports_gaps)
+		{
+			circular_buffer<int, 4> buf;
+			for (int i = 0; i < 6; ++i)
+				buf.push_back(i);
+			auto replay = buf.read_from(3);
+			Assert::IsFalse(replay.lapped());
+			std::vector<int> seen(replay.first.begin(), replay.first.end());
+			seen.insert(seen.end(), replay.second.begin(), replay.second.end());
+			Assert::IsTrue(seen == std::vector<int>{ 3, 4, 5 });
+			Assert::AreEqual(size_t(2), replay.second.size());
+			replay = buf.read_from(0);
+			Assert::IsTrue(replay.lapped());
+			Assert::AreEqual(uint64_t(2), replay.lost);
+			Assert::AreEqual(2, replay.first.front());
+			Assert::AreEqual(size_t(4), replay.first.size() + replay.second.size());
+			replay = buf.read_from(5);
+			Assert::AreEqual(5, replay.first.front());
+			Assert::IsTrue(replay.second.empty());
+			replay = buf.read_from(buf.next_seq());
+			Assert::IsTrue(replay.first.empty() && replay.second.empty() && !replay.lapped());
+		}
+	};
+
+	TEST_CLASS(seqlock_buffer)
+	{
+	public:
+		struct sample {
+			uint64_t seq;
+			uint64_t check[3];
+		};
+		static sample make_sample(uint64_t seq) {
+			return { seq, { seq * 3, seq * 5, ~seq } };
+		}
+		static bool intact(const sample& s) {
+			return s.check[0] == s.seq * 3 && s.check[1] == s.seq * 5 && s.check[2] == ~s.seq;
+		}
+
+		TEST_METHOD(reads_by_sequence_number)
+		{
+			seqlock_circular_buffer<int, 4> ring;
+			int val = -1;
+			Assert::IsTrue(ring.empty());
+			Assert::IsFalse(ring.latest(val));
+			Assert::IsFalse(ring.try_read(0, val));
+			for (int i = 0; i < 6; ++i)
+				ring.push(i * 10);
+			Assert::AreEqual(uint64_t(6), ring.next_seq());
+			Assert::AreEqual(size_t(4), ring.size());
+			Assert::IsFalse(ring.try_read(1, val));
+			Assert::IsTrue(ring.try_read(2, val));
+			Assert::AreEqual(20, val);
+			Assert::IsFalse(ring.try_read(6, val));
+			Assert::IsTrue(ring.latest(val));
+			Assert::AreEqual(50, val);
+		}
+		TEST_METHOD(snapshot_returns_newest_values)
+		{
+			seqlock_circular_buffer<int, 4> ring;
+			int out[8] = {};
+			Assert::AreEqual(size_t(0), ring.snapshot(out, 8));
+			ring.push(1);
+			ring.push(2);
+			Assert::AreEqual(size_t(2), ring.snapshot(out, 8));
+			Assert::AreEqual(1, out[0]);
+			Assert::AreEqual(2, out[1]);
+			for (int i = 3; i <= 7; ++i)
+				ring.push(i);
+			Assert::AreEqual(size_t(4), ring.snapshot(out, 8));
+			Assert::IsTrue(std::equal(out, out + 4, std::begin({ 4, 5, 6, 7 })));
+			Assert::AreEqual(size_t(2), ring.snapshot(out, 2));
+			Assert::AreEqual(6, out[0]);
+			Assert::AreEqual(7, out[1]);
+		}
+		TEST_METHOD(readers_never_see_torn_values)
+		{
+			constexpr uint64_t count = 200000;
+			seqlock_circular_buffer<sample, 64> ring;
+			std::atomic<bool> done{ false };
+			std::atomic<size_t> failures{ 0 };
+			std::vector<std::thread> readers;
+			for (int r = 0; r < 3; ++r) {
+				readers.emplace_back([&]() {
+					sample out[64];
+					uint64_t newest = 0;
+					while (!done.load()) {
+						const size_t n = ring.snapshot(out, 64);
+						for (size_t i = 0; i != n; ++i) {
+							if (!intact(out[i]) || (i != 0 && out[i].seq != out[i - 1].seq + 1))
+								++failures;
+						}
+						sample last;
+						if (ring.latest(last)) {
+							if (!intact(last) || last.seq < newest)
+								++failures;
+							newest = last.seq;
+						}
+						std::this_thread::yield();
+					}
+				});
+			}
+			for (uint64_t i = 0; i < count; ++i) {
+				ring.push(make_sample(i));
+				if (i % 1024 == 0)
+					std::this_thread::yield();
+			}
+			done = true;
+			for (std::thread& reader : readers)
+				reader.join();
+			Assert::AreEqual(size_t(0), failures.load());
+			sample last;
+			Assert::IsTrue(ring.latest(last));
+			Assert::AreEqual(count - 1, last.seq);
+		}
+		TEST_METHOD(failed_reads_leave_val_untouched)
+		{
+			constexpr uint64_t count = 200000;
+			seqlock_circular_buffer<sample, 4> ring;
+			sample val = make_sample(7);
+			Assert::IsFalse(ring.try_read(0, val));
+			Assert::AreEqual(uint64_t(7), val.seq);
+			std::atomic<bool> done{ false };
+			std::atomic<size_t> failures{ 0 };
+			std::thread reader([&]() {
+				const sample sentinel = make_sample(count);
+				while (!done.load()) {
+					// the oldest slot is the next one the writer overwrites
+					const uint64_t head = ring.next_seq();
+					sample out = sentinel;
+					if (head >= 4 && !ring.try_read(head - 4, out) && (out.seq != sentinel.seq || !intact(out)))
+						++failures;
+				}
+			});
+			for (uint64_t i = 0; i < count; ++i)
+				ring.push(make_sample(i));
+			done = true;
+			reader.join();
+			Assert::AreEqual(size_t(0), failures.load());
+		}
 	};
 }
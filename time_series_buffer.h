@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include "dynamic_circular_buffer.h"
+
+// dynamic_circular_buffer of (time, value) events whose times never decrease from the oldest
+// to the newest. Because the order is sorted, lower_bound, upper_bound and range binary search
+// the two contiguous segments in O(log n) and return views into the buffer without copying.
+// With overwrite_oldest as the policy the buffer keeps its capacity and drops the oldest events.
+template <class Time, class T, class FullPolicy = grow_when_full, class Alloc = std::allocator<std::pair<Time, T>>>
+class time_series_buffer {
+public:
+    using time_type = Time;
+    using value_type = std::pair<Time, T>;
+    using buffer_type = dynamic_circular_buffer<value_type, Alloc, FullPolicy>;
+    using const_iterator = typename buffer_type::const_iterator;
+    // the events of a time range, oldest first, split where the ring wraps
+    using range_type = std::pair<std::span<const value_type>, std::span<const value_type>>;
+
+    explicit time_series_buffer(size_t capacity = 0, const Alloc& alloc = Alloc())
+        : m_buffer(alloc) {
+        m_buffer.reserve(capacity);
+    }
+
+    // returns false when the policy dropped the event
+    template <typename... Args>
+    bool emplace(const Time& time, Args&&... args) {
+        if (!m_buffer.empty() && time < m_buffer.back().first)
+            throw std::invalid_argument("event is older than the newest one");
+        return m_buffer.emplace_back(std::piecewise_construct, std::forward_as_tuple(time), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+    bool push(const Time& time, const T& val) {
+        return emplace(time, val);
+    }
+    bool push(const Time& time, T&& val) {
+        return emplace(time, std::move(val));
+    }
+    void pop_front() {
+        m_buffer.pop_front();
+    }
+    // drops the events older than time
+    void erase_before(const Time& time) {
+        const size_t count = lower_bound(time) - cbegin();
+        for (size_t i = 0; i != count; ++i)
+            m_buffer.pop_front();
+    }
+    void clear() noexcept {
+        m_buffer.clear();
+    }
+
+    // first event at or after time
+    const_iterator lower_bound(const Time& time) const {
+        return find(time, [](const value_type& event, const Time& t) { return event.first < t; });
+    }
+    // first event after time
+    const_iterator upper_bound(const Time& time) const {
+        return find(time, [](const value_type& event, const Time& t) { return !(t < event.first); });
+    }
+    // events with from <= time < to
+    range_type range(const Time& from, const Time& to) const {
+        const const_iterator first = lower_bound(from);
+        const const_iterator last = to < from ? first : lower_bound(to);
+        return first.segments(last);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return m_buffer.cbegin();
+    }
+    const_iterator cend() const noexcept {
+        return m_buffer.cend();
+    }
+    const value_type& front() const noexcept {
+        return m_buffer.front();
+    }
+    const value_type& back() const noexcept {
+        return m_buffer.back();
+    }
+    const value_type& operator [](size_t offset) const noexcept {
+        return m_buffer[offset];
+    }
+    const buffer_type& buffer() const noexcept {
+        return m_buffer;
+    }
+    size_t size() const noexcept {
+        return m_buffer.size();
+    }
+    size_t capacity() const noexcept {
+        return m_buffer.capacity();
+    }
+    bool empty() const noexcept {
+        return m_buffer.empty();
+    }
+
+private:
+    // the second segment holds the newer events, so one comparison picks the segment to search
+    template <class Before>
+    const_iterator find(const Time& time, Before before) const {
+        const std::span<const value_type> one = m_buffer.array_one();
+        const std::span<const value_type> two = m_buffer.array_two();
+        size_t offset;
+        if (!two.empty() && before(one.back(), time))
+            offset = one.size() + (std::partition_point(two.begin(), two.end(), [&](const value_type& event) { return before(event, time); }) - two.begin());
+        else
+            offset = std::partition_point(one.begin(), one.end(), [&](const value_type& event) { return before(event, time); }) - one.begin();
+        const_iterator it = cbegin();
+        it += offset;
+        return it;
+    }
+
+    buffer_type m_buffer;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include "circular_buffer.h"
+
+// circular_buffer<T, N> that answers the minimum and maximum of its window in O(1). Next to
+// the values it keeps two monotonic rings of push numbers: a pushed value removes every
+// candidate it dominates from the back, and the candidate that falls out of the window leaves
+// from the front, so a push is amortized O(1). All three rings are allocated up front.
+template <class T, size_t N, class Compare = std::less<T>, class Alloc = std::allocator<T>>
+class window_extrema {
+    using index_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<size_t>;
+    using index_ring = circular_buffer<size_t, N, index_allocator>;
+
+public:
+    using value_type = T;
+    using buffer_type = circular_buffer<T, N, Alloc>;
+
+    explicit window_extrema(const Compare& compare = Compare())
+        : m_compare(compare) {}
+
+    void push(const T& val) {
+        m_values.push_back(val);
+        const size_t pushed = m_pushed++;
+        const size_t oldest = m_pushed - m_values.size();
+        // ties keep the newest position, it stays in the window longest
+        if (!m_min.empty() && m_min.front() < oldest)
+            m_min.pop_front();
+        while (!m_min.empty() && !m_compare(value(m_min.back()), val))
+            m_min.pop_back();
+        m_min.push_back(pushed);
+        if (!m_max.empty() && m_max.front() < oldest)
+            m_max.pop_front();
+        while (!m_max.empty() && !m_compare(val, value(m_max.back())))
+            m_max.pop_back();
+        m_max.push_back(pushed);
+    }
+    void clear() noexcept {
+        m_values.clear();
+        m_min.clear();
+        m_max.clear();
+        m_pushed = 0;
+    }
+
+    const T& window_min() const {
+        if (m_values.empty())
+            throw std::out_of_range("buffer is empty");
+        return value(m_min.front());
+    }
+    const T& window_max() const {
+        if (m_values.empty())
+            throw std::out_of_range("buffer is empty");
+        return value(m_max.front());
+    }
+
+    const buffer_type& buffer() const noexcept {
+        return m_values;
+    }
+    size_t size() const noexcept {
+        return m_values.size();
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return m_values.empty();
+    }
+    bool full() const noexcept {
+        return m_values.full();
+    }
+
+private:
+    const T& value(size_t pushed) const noexcept {
+        return m_values[pushed - (m_pushed - m_values.size())];
+    }
+
+    buffer_type m_values;
+    index_ring m_min;
+    index_ring m_max;
+    size_t m_pushed = 0;
+    [[no_unique_address]] Compare m_compare;
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "circular_buffer.h"
+
+// circular_buffer<T, N> that keeps sum, mean, variance and an EWMA of its contents up to date
+// on every push, so each query is O(1). When the window is full the pushed sample replaces the
+// oldest one in a single Welford step. The sum is compensated (Kahan), so it does not drift
+// after many evictions.
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class window_stats {
+    static_assert(std::is_arithmetic_v<T>, "window statistics need an arithmetic type");
+
+public:
+    using value_type = T;
+    using buffer_type = circular_buffer<T, N, Alloc>;
+
+    // alpha is the weight of the newest sample in the EWMA
+    explicit window_stats(double ewma_alpha = 2.0 / (N + 1.0))
+        : m_alpha(ewma_alpha) {
+        if (!(ewma_alpha > 0.0 && ewma_alpha <= 1.0))
+            throw std::invalid_argument("ewma alpha must be in (0, 1]");
+    }
+
+    void push(const T& val) {
+        const double x = static_cast<double>(val);
+        if (m_buffer.full()) {
+            const double y = static_cast<double>(m_buffer.front());
+            const double mean = m_mean + (x - y) / N;
+            m_m2 += (x - y) * (x - mean + y - m_mean);
+            m_mean = mean;
+            add_to_sum(-y);
+        }
+        else {
+            const size_t n = m_buffer.size() + 1;
+            const double delta = x - m_mean;
+            m_mean += delta / n;
+            m_m2 += delta * (x - m_mean);
+        }
+        add_to_sum(x);
+        // rounding may leave a tiny negative value when all samples are equal
+        if (m_m2 < 0.0)
+            m_m2 = 0.0;
+        m_ewma = m_samples == 0 ? x : m_ewma + m_alpha * (x - m_ewma);
+        ++m_samples;
+        m_buffer.push_back(val);
+    }
+    void clear() noexcept {
+        m_buffer.clear();
+        m_sum = 0.0;
+        m_compensation = 0.0;
+        m_mean = 0.0;
+        m_m2 = 0.0;
+        m_ewma = 0.0;
+        m_samples = 0;
+    }
+
+    double sum() const noexcept {
+        return m_sum;
+    }
+    double mean() const noexcept {
+        return m_mean;
+    }
+    // population variance of the window
+    double variance() const noexcept {
+        return m_buffer.empty() ? 0.0 : m_m2 / m_buffer.size();
+    }
+    double sample_variance() const noexcept {
+        return m_buffer.size() < 2 ? 0.0 : m_m2 / (m_buffer.size() - 1);
+    }
+    double stddev() const noexcept {
+        return std::sqrt(variance());
+    }
+    // covers every sample pushed since construction or clear, not only the window
+    double ewma() const noexcept {
+        return m_ewma;
+    }
+    double ewma_alpha() const noexcept {
+        return m_alpha;
+    }
+
+    const buffer_type& buffer() const noexcept {
+        return m_buffer;
+    }
+    size_t size() const noexcept {
+        return m_buffer.size();
+    }
+    constexpr size_t capacity() const noexcept {
+        return N;
+    }
+    bool empty() const noexcept {
+        return m_buffer.empty();
+    }
+    bool full() const noexcept {
+        return m_buffer.full();
+    }
+
+private:
+    void add_to_sum(double x) noexcept {
+        const double y = x - m_compensation;
+        const double t = m_sum + y;
+        m_compensation = (t - m_sum) - y;
+        m_sum = t;
+    }
+
+    buffer_type m_buffer;
+    double m_alpha;
+    double m_sum = 0.0;
+    double m_compensation = 0.0;
+    double m_mean = 0.0;
+    double m_m2 = 0.0;
+    double m_ewma = 0.0;
+    size_t m_samples = 0;
+};